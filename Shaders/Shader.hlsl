@@ -8,21 +8,39 @@ struct PSInput
 {
     float4 position : SV_POSITION;
     float2 texCoord : TEXCOORD;
+    nointerpolation float4 color : COLOR;
 };
 
-cbuffer TileConstantBuffer : register(b0)
+// Same layout as TileInstance in TileInstances.h.
+struct TileInstance
 {
-    float4x4 position;
-    float4 color;
+    float2 offset;
+    uint color;     // RGBA8, red in the low byte
 };
 
-PSInput VS(VSInput input)
+// Root constants, set once per frame.
+cbuffer BoardConstants : register(b0)
 {
-    PSInput result;    
-    
-    result.position = mul(float4(input.position, 1.0f), position);
-        
+    float4x4 viewProjection;
+    float tileSize;
+};
+
+StructuredBuffer<TileInstance> tiles : register(t1);
+
+float4 UnpackColor(uint color)
+{
+    return float4(color & 0xff, (color >> 8) & 0xff, (color >> 16) & 0xff, color >> 24) / 255.0f;
+}
+
+PSInput VS(VSInput input, uint instance : SV_InstanceID)
+{
+    PSInput result;
+    TileInstance instanceData = tiles[instance];
+
+    float2 position = input.position.xy * tileSize + instanceData.offset;
+    result.position = mul(float4(position, input.position.z, 1.0f), viewProjection);
     result.texCoord = input.texCoord;
+    result.color = UnpackColor(instanceData.color);
 
     return result;
 }
@@ -32,8 +50,8 @@ SamplerState gSamPoint : register(s0);
 
 float4 PS(PSInput input) : SV_TARGET
 {
-    float4 texColor = tile.Sample(gSamPoint, input.texCoord) * color;
-    
+    float4 texColor = tile.Sample(gSamPoint, input.texCoord) * input.color;
+
     return texColor;
 }
 
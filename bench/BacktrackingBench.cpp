@@ -0,0 +1,102 @@
+// Counts tours exhaustively on small boards and samples tours on 8x8, with the harness in
+// Benchmark.h (see there for the options). Items are nodes, or tours for the 8x8 sample, so
+// items/s is the search rate.
+//
+// First checks the tour counts with and without a transposition table, printing each table's
+// hit rate, and exits with 1 if one is wrong.
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "Backtracking.h"
+#include "Benchmark.h"
+
+namespace {
+
+constexpr uint64_t cornerOpenTours5x5 = 304;
+constexpr uint64_t cornerClosedTours6x6 = 19724;
+
+struct TableSetup {
+	size_t memoryBytes;
+	ReplacementPolicy policy;
+};
+
+constexpr TableSetup tableSetups[] = {
+	{ size_t(64) << 20, ReplacementPolicy::DepthPreferred },
+	{ size_t(1) << 20, ReplacementPolicy::DepthPreferred },
+	{ size_t(1) << 20, ReplacementPolicy::AlwaysReplace },
+};
+
+bool check_counts() {
+	bool ok = Backtracking<5, 5>(TourType::Open).count(0).tours == cornerOpenTours5x5;
+	ok &= Backtracking<6, 6>(TourType::Closed).count(0).tours == cornerClosedTours6x6;
+	for(const TableSetup& setup : tableSetups) {
+		TranspositionTable table(setup.memoryBytes, setup.policy);
+		SearchStats stats = Backtracking<6, 6>(TourType::Closed).count(0, table);
+		ok &= stats.tours == cornerClosedTours6x6;
+		std::cout << "6x6 closed tours from 0 with " << (table.memory_bytes() >> 20) << " MB table"
+			<< (setup.policy == ReplacementPolicy::AlwaysReplace ? " (always replace)" : " (depth preferred)") << ": "
+			<< stats.tours << " (" << stats.nodes << " nodes, hit rate " << stats.hit_rate() * 100.0 << "%)\n";
+	}
+	if(ok == false)
+		std::cout << "Wrong tour count.\n";
+	return ok;
+}
+
+// The whole search from the corner, or its first range() nodes when registered with Arg().
+template <int Rows, int Columns, TourType Type>
+void count(bench::State& state) {
+	SearchLimits limits;
+	limits.maxNodes = static_cast<uint64_t>(state.range());
+	uint64_t nodes = 0;
+	for(auto _ : state)
+		nodes += Backtracking<Rows, Columns>(Type, limits).count(0).nodes;
+	state.set_items_per_iteration(nodes / state.max_iterations());
+}
+
+// The whole 6x6 closed count with a fresh table, including clearing it.
+template <int Setup>
+void count_with_table(bench::State& state) {
+	uint64_t nodes = 0;
+	for(auto _ : state) {
+		TranspositionTable table(tableSetups[Setup].memoryBytes, tableSetups[Setup].policy);
+		nodes += Backtracking<6, 6>(TourType::Closed).count(0, table).nodes;
+	}
+	state.set_items_per_iteration(nodes / state.max_iterations());
+}
+
+void sample_8x8(bench::State& state) {
+	SearchLimits limits;
+	limits.maxTours = static_cast<uint64_t>(state.range());
+	state.set_items_per_iteration(limits.maxTours);
+	for(auto _ : state)
+		bench::do_not_optimize(Backtracking<8, 8>(TourType::Open, limits, true).enumerate(0, [](const auto&) { return true; }).tours);
+}
+
+// Semi-magic search is far too big to finish, so only its first nodes.
+void semi_magic_8x8(bench::State& state) {
+	SearchLimits limits;
+	limits.maxNodes = static_cast<uint64_t>(state.range());
+	state.set_items_per_iteration(limits.maxNodes);
+	for(auto _ : state)
+		bench::do_not_optimize(Backtracking<8, 8>(TourType::Open, limits, false, MagicConstraint::SemiMagic).count(0).tours);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	if(check_counts() == false)
+		return 1;
+	std::cout << "\n";
+
+	bench::register_benchmark("count/5x5/open", count<5, 5, TourType::Open>);
+	bench::register_benchmark("count/6x6/closed", count<6, 6, TourType::Closed>);
+	bench::register_benchmark("count/6x6/open", count<6, 6, TourType::Open>).Arg(4000000);
+	bench::register_benchmark("count/6x6/closed/64mb_depth_preferred", count_with_table<0>);
+	bench::register_benchmark("count/6x6/closed/1mb_depth_preferred", count_with_table<1>);
+	bench::register_benchmark("count/6x6/closed/1mb_always_replace", count_with_table<2>);
+	bench::register_benchmark("sample/8x8/open", sample_8x8).Arg(10000);
+	bench::register_benchmark("semi_magic/8x8", semi_magic_8x8).Arg(2000000);
+	return bench::run(argc, argv);
+}
@@ -0,0 +1,58 @@
+// Moves per second of BatchWalker, for each policy and a few batch sizes. Build with
+// KNIGHTSTOUR_NATIVE_ARCH=ON to get the AVX2 or AVX-512 path on machines that have it.
+// Takes the options of Benchmark.h.
+//
+// First prints the share of full tours and a checksum of a fixed number of walks for every
+// case, which must match between the scalar and SIMD builds.
+
+#include <iostream>
+#include <string>
+
+#include "BatchWalker.h"
+#include "Benchmark.h"
+
+namespace {
+
+constexpr uint64_t checkedWalks = 200000;
+
+template <int Rows, int Columns>
+void print_checksum(BatchPolicy policy, int boards) {
+	BatchWalker<Rows, Columns> walker(boards, 42, policy);
+	uint64_t endSum = 0;
+	BatchStats stats = walker.run(checkedWalks, [&](int, int, int end) { endSum += end; });
+
+	std::cout << Rows << "x" << Columns << (policy == BatchPolicy::Warnsdorff ? " warnsdorff" : " uniform")
+		<< ", " << walker.boards() << " boards: " << 100.0 * stats.fullTours / stats.walks << "% full tours, checksum "
+		<< (endSum ^ stats.moves) << "\n";
+}
+
+// Items are moves, so items/s is the move rate. Each iteration walks every board 16 times, so
+// boards left idle at the end of a run barely count.
+template <int Rows, int Columns, BatchPolicy Policy>
+void walk(bench::State& state) {
+	BatchWalker<Rows, Columns> walker(static_cast<int>(state.range()), 42, Policy);
+	const uint64_t walks = 16 * static_cast<uint64_t>(walker.boards());
+	uint64_t moves = 0;
+	for(auto _ : state) {
+		BatchStats stats = walker.run(walks, [](int, int, int) {});
+		moves += stats.moves;
+	}
+	state.set_items_per_iteration(moves / state.max_iterations());
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::cout << "Instruction set: " << BatchWalker<8, 8>::instruction_set() << "\n";
+	for(int boards : { 8, 256, 4096 }) {
+		print_checksum<8, 8>(BatchPolicy::Warnsdorff, boards);
+		print_checksum<8, 8>(BatchPolicy::Uniform, boards);
+	}
+	print_checksum<6, 6>(BatchPolicy::Warnsdorff, 4096);
+	std::cout << "\n";
+
+	bench::register_benchmark("walk/8x8/warnsdorff", walk<8, 8, BatchPolicy::Warnsdorff>).Arg(8).Arg(256).Arg(4096);
+	bench::register_benchmark("walk/8x8/uniform", walk<8, 8, BatchPolicy::Uniform>).Arg(8).Arg(256).Arg(4096);
+	bench::register_benchmark("walk/6x6/warnsdorff", walk<6, 6, BatchPolicy::Warnsdorff>).Arg(4096);
+	return bench::run(argc, argv);
+}
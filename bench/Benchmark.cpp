@@ -0,0 +1,192 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+namespace bench {
+
+namespace {
+
+struct Options {
+	std::string filter;
+	double minTime = 0.2;
+	int repetitions = 3;
+	std::string json;
+	std::string baseline;
+	double threshold = 0.1;
+};
+
+struct Result {
+	std::string name;
+	uint64_t iterations;
+	double nsPerIteration;
+	double itemsPerSecond;
+};
+
+std::deque<Registration>& registry() {
+	static std::deque<Registration> benchmarks;
+	return benchmarks;
+}
+
+// Seconds taken by one run of function over iterations.
+double time_run(const Function& function, uint64_t iterations, int64_t argument, uint64_t& items) {
+	State state(iterations, argument);
+	function(state);
+	items = state.items_per_iteration();
+	return state.elapsed_seconds();
+}
+
+Result measure(const std::string& name, const Function& function, int64_t argument, const Options& options) {
+	// Grow the iteration count until a run is long enough to time, then size the real runs
+	// to take minTime each.
+	uint64_t items = 1;
+	uint64_t iterations = 1;
+	double seconds = time_run(function, iterations, argument, items);
+	while(seconds < options.minTime / 10 && iterations < (uint64_t(1) << 40)) {
+		iterations *= 10;
+		seconds = time_run(function, iterations, argument, items);
+	}
+	if(seconds < options.minTime)
+		iterations = static_cast<uint64_t>(iterations * options.minTime / std::max(seconds, 1e-9)) + 1;
+
+	std::vector<double> times;
+	for(int i = 0; i < options.repetitions; ++i)
+		times.push_back(time_run(function, iterations, argument, items) * 1e9 / iterations);
+	std::sort(times.begin(), times.end());
+	double median = times[times.size() / 2];
+
+	return Result{ name, iterations, median, items * 1e9 / median };
+}
+
+void write_json(const std::string& path, const std::vector<Result>& results) {
+	std::ofstream out(path);
+	out << "{\n  \"benchmarks\": [\n";
+	for(size_t i = 0; i < results.size(); ++i) {
+		const Result& result = results[i];
+		out << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+			<< ", \"real_time\": " << std::setprecision(6) << result.nsPerIteration
+			<< ", \"time_unit\": \"ns\", \"items_per_second\": " << result.itemsPerSecond << "}"
+			<< (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	out << "  ]\n}\n";
+}
+
+// Reads the name and real_time of every benchmark from a file written by write_json.
+// Only understands that layout, which is all a baseline ever is.
+bool read_baseline(const std::string& path, std::map<std::string, double>& times) {
+	std::ifstream in(path);
+	if(in.is_open() == false)
+		return false;
+
+	std::string line;
+	while(std::getline(in, line)) {
+		size_t name = line.find("\"name\": \"");
+		size_t time = line.find("\"real_time\": ");
+		if(name == std::string::npos || time == std::string::npos)
+			continue;
+		name += 9;
+		std::string benchmark = line.substr(name, line.find('"', name) - name);
+		times[benchmark] = std::stod(line.substr(time + 13));
+	}
+	return true;
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+	for(int i = 1; i < argc; ++i) {
+		std::string argument = argv[i];
+		if(i + 1 >= argc) {
+			std::cout << "Missing value for " << argument << ".\n";
+			return false;
+		}
+		std::string value = argv[++i];
+		if(argument == "--filter")
+			options.filter = value;
+		else if(argument == "--min-time")
+			options.minTime = std::stod(value);
+		else if(argument == "--repetitions")
+			options.repetitions = std::max(1, std::stoi(value));
+		else if(argument == "--json")
+			options.json = value;
+		else if(argument == "--baseline")
+			options.baseline = value;
+		else if(argument == "--threshold")
+			options.threshold = std::stod(value);
+		else {
+			std::cout << "Unknown option " << argument << ".\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+Registration& register_benchmark(const std::string& name, Function function) {
+	registry().push_back(Registration{ name, std::move(function), {} });
+	return registry().back();
+}
+
+int run(int argc, char* argv[]) {
+	Options options;
+	if(parse_options(argc, argv, options) == false)
+		return 2;
+
+	std::map<std::string, double> baseline;
+	if(options.baseline.empty() == false && read_baseline(options.baseline, baseline) == false) {
+		std::cout << "Could not read baseline " << options.baseline << ".\n";
+		return 2;
+	}
+
+	std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(14) << "ns/op"
+		<< std::setw(16) << "items/s" << std::setw(14) << "iterations" << "\n";
+
+	std::vector<Result> results;
+	int regressions = 0;
+	for(const Registration& benchmark : registry()) {
+		std::vector<int64_t> arguments = benchmark.arguments;
+		if(arguments.empty())
+			arguments.push_back(0);
+
+		for(int64_t argument : arguments) {
+			std::string name = benchmark.name;
+			if(benchmark.arguments.empty() == false)
+				name += "/" + std::to_string(argument);
+			if(name.find(options.filter) == std::string::npos)
+				continue;
+
+			Result result = measure(name, benchmark.function, argument, options);
+			results.push_back(result);
+
+			std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(14) << result.nsPerIteration << std::setprecision(0)
+				<< std::setw(16) << result.itemsPerSecond << std::setw(14) << result.iterations;
+
+			auto previous = baseline.find(name);
+			if(previous != baseline.end()) {
+				double change = result.nsPerIteration / previous->second - 1.0;
+				std::cout << std::setprecision(1) << "  " << std::showpos << change * 100.0 << "%" << std::noshowpos;
+				if(change > options.threshold) {
+					std::cout << " REGRESSION";
+					++regressions;
+				}
+			}
+			std::cout << std::defaultfloat << "\n";
+		}
+	}
+
+	if(options.json.empty() == false)
+		write_json(options.json, results);
+
+	if(regressions > 0) {
+		std::cout << regressions << " benchmark(s) slower than the baseline by more than "
+			<< options.threshold * 100.0 << "%.\n";
+		return 1;
+	}
+	return 0;
+}
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+// Small benchmark harness in the style of Google Benchmark, so the suite builds without
+// external dependencies. Benchmarks are functions taking a State and looping over it:
+//
+//     void example(bench::State& state) {
+//         for(auto _ : state)
+//             bench::do_not_optimize(work());
+//     }
+//     BENCHMARK(example);
+//     BENCHMARK(sized).Arg(8).Arg(16);		// state.range() is 8, then 16
+//
+// and main() calls bench::run(argc, argv). Each benchmark is run until it has taken at least
+// --min-time seconds, several times, and the median time per iteration is reported.
+//
+// Options:
+//   --filter text       only run benchmarks whose name contains text
+//   --min-time seconds  time per repetition (default 0.2)
+//   --repetitions N     repetitions per benchmark (default 3)
+//   --json file         also write the results as JSON
+//   --baseline file     compare with a JSON file written earlier
+//   --threshold value   allowed slowdown against the baseline, 0.1 is 10% (default 0.1)
+//
+// With a baseline the exit code is 1 when any benchmark got slower than the threshold allows.
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+class State {
+public:
+	State(uint64_t iterations, int64_t range) : iterations(iterations), argument(range) {}
+
+	// The loop variable. User provided members keep unused variable warnings quiet.
+	struct Value {
+		Value() {}
+		~Value() {}
+	};
+
+	// Times only the loop, so setup before it and cleanup after it are free.
+	struct Iterator {
+		State* state;
+		uint64_t remaining;
+		bool operator!=(const Iterator&) {
+			if(remaining != 0)
+				return true;
+			state->stop = std::chrono::steady_clock::now();
+			return false;
+		}
+		void operator++() { --remaining; }
+		Value operator*() const { return Value(); }
+	};
+
+	Iterator begin() {
+		start = std::chrono::steady_clock::now();
+		return Iterator{ this, iterations };
+	}
+	Iterator end() { return Iterator{ this, 0 }; }
+
+	double elapsed_seconds() const { return std::chrono::duration<double>(stop - start).count(); }
+
+	uint64_t max_iterations() const { return iterations; }
+
+	// The value the benchmark was registered with by Arg().
+	int64_t range(int = 0) const { return argument; }
+
+	// Work items handled per iteration, when one iteration does more than one operation.
+	void set_items_per_iteration(uint64_t items) { itemsPerIteration = items; }
+	uint64_t items_per_iteration() const { return itemsPerIteration; }
+
+private:
+	uint64_t iterations;
+	int64_t argument;
+	uint64_t itemsPerIteration = 1;
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point stop;
+};
+
+using Function = std::function<void(State&)>;
+
+struct Registration {
+	std::string name;
+	Function function;
+	std::vector<int64_t> arguments;	// One run per argument, or a single run without one.
+
+	// Adds a run of the benchmark, named name/argument, where state.range() is argument.
+	Registration& Arg(int64_t argument) {
+		arguments.push_back(argument);
+		return *this;
+	}
+};
+
+Registration& register_benchmark(const std::string& name, Function function);
+
+// Keeps the compiler from optimising away a value that is otherwise unused.
+template <typename Type>
+inline void do_not_optimize(const Type& value) {
+#if defined(_MSC_VER)
+	static volatile const void* sink;
+	sink = &value;
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+int run(int argc, char* argv[]);
+
+}
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+#define BENCHMARK(function) \
+	static ::bench::Registration& BENCHMARK_CONCAT(benchmarkRegistration, __LINE__) = \
+		::bench::register_benchmark(#function, function)
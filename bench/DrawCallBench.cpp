@@ -0,0 +1,219 @@
+// Counts the command list calls and upload bytes a frame of the board takes, without a GPU,
+// by recording into a command list that only counts. Compares one instanced draw fed from a
+// structured buffer (TileInstances, what SceneRenderer does now) with the old draw per tile,
+// each with its own 256 byte constant buffer, on boards from 8x8 up to 1000x1000.
+//
+// The timed benchmarks after the table refresh the tile colours and copy the per frame data
+// to a stand-in for upload memory, the CPU side of LoadTiles. The replay ones step through a
+// Warnsdorff tour one move per iteration, recolouring either the whole board or just the
+// neighbourhoods of the tiles the knight left and landed on. replay_runs is what SceneRenderer
+// does now: the recoloured tiles grouped into runs and packed into upload memory, one buffer
+// copy per run.
+//
+// Exits with 1 if the instanced path ever takes more than one draw call.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "Benchmark.h"
+#include "BoardGraph.h"
+#include "TileInstances.h"
+#include "Warnsdorff.h"
+
+namespace {
+
+// Stands in for ID3D12GraphicsCommandList, counting what would be recorded.
+struct CountingCommandList {
+	uint64_t calls = 0;
+	uint64_t draws = 0;
+	uint64_t instances = 0;
+
+	void set_tile_size(float) { ++calls; }
+	void set_instance_buffer(uint64_t) { ++calls; }
+	void set_constant_buffer(uint64_t) { ++calls; }
+	void draw_instanced(uint32_t, uint32_t instanceCount) {
+		++calls;
+		++draws;
+		instances += instanceCount;
+	}
+};
+
+// The old per tile constant buffer, padded to the 256 bytes constant buffer views need.
+struct TileConstants {
+	float mvp[16];
+	float color[4];
+	float padding[44];
+};
+static_assert(sizeof(TileConstants) == 256, "Constant buffer views are 256 byte aligned.");
+
+// What the old Draw recorded: a constant buffer view and a single instance draw per tile.
+void record_per_tile(CountingCommandList& list, int tileCount) {
+	for(int tile = 0; tile < tileCount; ++tile) {
+		list.set_constant_buffer(static_cast<uint64_t>(tile) * sizeof(TileConstants));
+		list.draw_instanced(TileInstances::indicesPerTile, 1);
+	}
+}
+
+uint32_t tile_color(int tile, int frame) {
+	return (tile + frame) % 3 == 0 ? pack_rgba8(0.3f, 0.3f, 0.7f, 0.5f) : pack_rgba8(1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+// Packs the runs of recoloured tiles into upload like SceneRenderer::UploadDirtyTiles and
+// returns how many buffer copies that takes.
+size_t upload_runs(TileInstances& tiles, std::vector<uint8_t>& upload) {
+	size_t offset = 0;
+	const std::vector<TileRun>& runs = tiles.take_dirty_runs();
+	for(const TileRun& run : runs) {
+		std::memcpy(upload.data() + offset, tiles.data() + run.first, run.count * sizeof(TileInstance));
+		offset += run.count * sizeof(TileInstance);
+	}
+	return runs.size();
+}
+
+bool print_calls(int size) {
+	TileInstances tiles(size, size);
+	CountingCommandList instanced;
+	tiles.record_draw(instanced, uint64_t(0));
+	CountingCommandList perTile;
+	record_per_tile(perTile, tiles.count());
+
+	std::cout << size << "x" << size << ": instanced " << instanced.calls << " calls, " << instanced.draws << " draw, "
+		<< tiles.byte_size() << " bytes | per tile " << perTile.calls << " calls, " << perTile.draws << " draws, "
+		<< static_cast<uint64_t>(tiles.count()) * sizeof(TileConstants) << " bytes\n";
+	return instanced.draws == 1 && instanced.instances == static_cast<uint64_t>(tiles.count());
+}
+
+// New colours for every tile, then the whole instance array copied for the GPU.
+void update_instances(bench::State& state) {
+	const int size = static_cast<int>(state.range());
+	TileInstances tiles(size, size);
+	std::vector<uint8_t> upload(tiles.byte_size());
+	state.set_items_per_iteration(tiles.count());
+	int frame = 0;
+	for(auto _ : state) {
+		for(int tile = 0; tile < tiles.count(); ++tile)
+			tiles.set_color(tile, tile_color(tile, frame));
+		upload_runs(tiles, upload);
+		bench::do_not_optimize(upload.data());
+		++frame;
+	}
+}
+
+// The old LoadTiles: a translation matrix and a colour written into 256 bytes per tile.
+void update_constants(bench::State& state) {
+	const int size = static_cast<int>(state.range());
+	TileInstances tiles(size, size);
+	std::vector<TileConstants> upload(tiles.count());
+	state.set_items_per_iteration(tiles.count());
+	int frame = 0;
+	for(auto _ : state) {
+		for(int tile = 0; tile < tiles.count(); ++tile) {
+			TileConstants constants{};
+			constants.mvp[0] = constants.mvp[5] = constants.mvp[10] = constants.mvp[15] = 1.0f;
+			constants.mvp[12] = tiles[tile].x;
+			constants.mvp[13] = tiles[tile].y;
+			uint32_t color = tile_color(tile, frame);
+			for(int channel = 0; channel < 4; ++channel)
+				constants.color[channel] = ((color >> (8 * channel)) & 0xff) / 255.0f;
+			std::memcpy(&upload[tile], &constants, sizeof(constants));
+		}
+		bench::do_not_optimize(upload.data());
+		++frame;
+	}
+}
+
+// A tour being replayed, coloured like SceneRenderer::TileColor.
+struct Replay {
+	BoardGraph board;
+	TileInstances tiles;
+	std::vector<uint32_t> tour;
+	std::vector<uint8_t> visited;
+	std::vector<uint8_t> upload;
+	int move = 0;
+
+	explicit Replay(int size)
+		: board(BoardShape::rectangle(size, size)), tiles(size, size), visited(board.tile_count(), 0), upload(tiles.byte_size()) {
+		warnsdorff_tour(board, 0, tour, TieBreak::SquirrelCull);
+	}
+
+	int current() const { return move > 0 ? static_cast<int>(tour[move - 1]) : -1; }
+
+	uint32_t color(int tile) const {
+		if(tile == current())
+			return pack_rgba8(0.5f, 1.0f, 0.5f, 0.0f);
+		if(visited[tile])
+			return pack_rgba8(0.3f, 0.3f, 0.3f, 1.0f);
+		bool visitable = false;
+		if(current() >= 0)
+			board.for_each_move(current(), [&](int target) { visitable |= target == tile; });
+		return visitable ? pack_rgba8(0.3f, 0.3f, 0.7f, 0.5f) : pack_rgba8(1.0f, 1.0f, 1.0f, 1.0f);
+	}
+
+	// Plays the next move, starting over after the last one, and returns the tile left.
+	int step() {
+		if(move == static_cast<int>(tour.size())) {
+			move = 0;
+			std::fill(visited.begin(), visited.end(), 0);
+			for(int tile = 0; tile < tiles.count(); ++tile)
+				tiles.set_color(tile, color(tile));
+		}
+		int previous = current();
+		visited[tour[move++]] = 1;
+		return previous;
+	}
+
+	void recolor_neighbourhood(int tile) {
+		if(tile < 0)
+			return;
+		tiles.set_color(tile, color(tile));
+		board.for_each_move(tile, [&](int target) { tiles.set_color(target, color(target)); });
+	}
+};
+
+// The old LoadTiles after every move: every tile recoloured, the whole buffer copied.
+void replay_full(bench::State& state) {
+	Replay replay(static_cast<int>(state.range()));
+	for(auto _ : state) {
+		replay.step();
+		for(int tile = 0; tile < replay.tiles.count(); ++tile)
+			replay.tiles.set_color(tile, replay.color(tile));
+		std::memcpy(replay.upload.data(), replay.tiles.data(), replay.tiles.byte_size());
+		bench::do_not_optimize(replay.upload.data());
+	}
+}
+
+// SceneRenderer::UploadDirtyTiles: runs of recoloured tiles packed into a staging buffer.
+void replay_runs(bench::State& state) {
+	Replay replay(static_cast<int>(state.range()));
+	uint64_t copies = 0;
+	for(auto _ : state) {
+		int previous = replay.step();
+		replay.recolor_neighbourhood(previous);
+		replay.recolor_neighbourhood(replay.current());
+		copies += upload_runs(replay.tiles, replay.upload);
+		bench::do_not_optimize(replay.upload.data());
+	}
+	bench::do_not_optimize(copies);
+}
+
+}
+
+BENCHMARK(update_instances).Arg(8).Arg(100).Arg(1000);
+BENCHMARK(update_constants).Arg(8).Arg(100).Arg(1000);
+BENCHMARK(replay_full).Arg(8).Arg(100).Arg(1000);
+BENCHMARK(replay_runs).Arg(8).Arg(100).Arg(1000);
+
+int main(int argc, char* argv[]) {
+	bool constant = true;
+	for(int size : { 8, 100, 1000 })
+		constant &= print_calls(size);
+	std::cout << "\n";
+	if(constant == false) {
+		std::cout << "The instanced path took more than one draw call.\n";
+		return 1;
+	}
+	return bench::run(argc, argv);
+}
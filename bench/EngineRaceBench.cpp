@@ -0,0 +1,197 @@
+// Races the backtracking search against the SAT engine on the same puzzles, and shows the
+// puzzles only the SAT engine can express (blocked tiles). Prints what each engine concludes,
+// then times both with the harness in Benchmark.h (see there for the options).
+//
+// Backtracking has no notion of pre-placed numbers, so for those puzzles it enumerates tours
+// from move 1 and checks each finished tour against the numbers, the way a search over
+// calculate_visitable_tile would. That is what explodes on bigger boards, so it gives up
+// after maxNodes.
+//
+// Exits with 1 if the SAT engine returns an invalid tour or the wrong answer.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Backtracking.h"
+#include "Benchmark.h"
+#include "Board.h"
+#include "SatTour.h"
+#include "Warnsdorff.h"
+
+namespace {
+
+constexpr uint64_t maxNodes = 2000000;
+
+// Whether tour is a knight path over every open tile that matches the constraints.
+template <int Rows, int Columns>
+bool check(const std::vector<uint32_t>& tour, const TourConstraints& constraints) {
+	using BoardType = Board<Rows, Columns>;
+	std::vector<int> visits(BoardType::tileCount, 0);
+	for(int tile : constraints.blocked)
+		visits[tile] = 2;
+	for(uint32_t tile : tour)
+		++visits[tile];
+	for(int count : visits) {
+		if(count != 1 && count != 2)
+			return false;
+	}
+
+	auto is_move = [](int from, int to) {
+		bool found = false;
+		BoardType::for_each_move(from, [&](int target) { found |= target == to; });
+		return found;
+	};
+	for(size_t i = 1; i < tour.size(); ++i) {
+		if(is_move(tour[i - 1], tour[i]) == false)
+			return false;
+	}
+	if(constraints.type == TourType::Closed && is_move(tour.back(), tour.front()) == false)
+		return false;
+	for(const auto& number : constraints.numbers) {
+		if(tour[number.second - 1] != static_cast<uint32_t>(number.first))
+			return false;
+	}
+	return true;
+}
+
+const char* status_name(SatStatus status) {
+	switch(status) {
+	case SatStatus::Satisfiable:
+		return "tour found";
+	case SatStatus::Unsatisfiable:
+		return "proved impossible";
+	default:
+		return "gave up";
+	}
+}
+
+template <int Rows, int Columns>
+bool run_sat(const TourConstraints& constraints, SatStatus expected) {
+	std::vector<uint32_t> tour;
+	SatTourStats stats = sat_tour(Board<Rows, Columns>(), constraints, tour);
+
+	bool valid = stats.status == expected;
+	std::cout << "  sat:          " << status_name(stats.status);
+	if(stats.status == SatStatus::Satisfiable && check<Rows, Columns>(tour, constraints) == false) {
+		std::cout << " (INVALID)";
+		valid = false;
+	}
+	else if(valid == false)
+		std::cout << " (WRONG)";
+	std::cout << ", " << stats.variables << " variables, " << stats.clauses << " clauses, "
+		<< stats.solver.conflicts << " conflicts, " << stats.solver.decisions << " decisions\n";
+	return valid;
+}
+
+// First tour from the tile numbered 1 that matches the numbers, or a proof there is none.
+template <int Rows, int Columns>
+SearchStats backtrack(const TourConstraints& constraints, bool& found) {
+	SearchLimits limits;
+	limits.maxNodes = maxNodes;
+	int start = 0;
+	for(const auto& number : constraints.numbers) {
+		if(number.second == 1)
+			start = number.first;
+	}
+
+	found = false;
+	return Backtracking<Rows, Columns>(constraints.type, limits).enumerate(start, [&](const auto& tour) {
+		for(const auto& number : constraints.numbers) {
+			if(tour[number.second - 1] != number.first)
+				return true;
+		}
+		found = true;
+		return false;
+	});
+}
+
+template <int Rows, int Columns>
+void run_backtracking(const TourConstraints& constraints) {
+	bool found;
+	SearchStats stats = backtrack<Rows, Columns>(constraints, found);
+	std::cout << "  backtracking: " << (found ? "tour found" : stats.completed ? "proved impossible" : "gave up")
+		<< ", " << stats.nodes << " nodes, " << stats.tours << " tours checked\n";
+}
+
+std::string benchmark_name(int rows, int columns, const std::string& name) {
+	return std::to_string(rows) + "x" + std::to_string(columns) + "/" + name;
+}
+
+// Prints what the SAT engine concludes and registers it as sat/name.
+template <int Rows, int Columns>
+bool run_sat_only(const std::string& name, const TourConstraints& constraints, SatStatus expected) {
+	std::cout << Rows << "x" << Columns << " " << name << "\n";
+	bench::register_benchmark("sat/" + benchmark_name(Rows, Columns, name), [constraints](bench::State& state) {
+		std::vector<uint32_t> tour;
+		for(auto _ : state)
+			bench::do_not_optimize(sat_tour(Board<Rows, Columns>(), constraints, tour).status);
+	});
+	return run_sat<Rows, Columns>(constraints, expected);
+}
+
+// Same for both engines, registering backtracking/name as well.
+template <int Rows, int Columns>
+bool race(const std::string& name, const TourConstraints& constraints, SatStatus expected) {
+	bench::register_benchmark("backtracking/" + benchmark_name(Rows, Columns, name), [constraints](bench::State& state) {
+		bool found;
+		for(auto _ : state)
+			bench::do_not_optimize(backtrack<Rows, Columns>(constraints, found).nodes);
+	});
+	bool ok = run_sat_only<Rows, Columns>(name, constraints, expected);
+	run_backtracking<Rows, Columns>(constraints);
+	return ok;
+}
+
+// Numbers every step-th move of a Warnsdorff tour, plus move 1, so the puzzle has a solution.
+template <int Rows, int Columns>
+TourConstraints numbered_puzzle(int start, int step, uint64_t seed) {
+	typename Warnsdorff<Rows, Columns>::Tour tour{};
+	int length = 0;
+	for(uint64_t attempt = seed; length != Rows * Columns; ++attempt)
+		length = Warnsdorff<Rows, Columns>(TieBreak::Random, attempt).solve(start, tour);
+
+	TourConstraints constraints;
+	for(int move = 1; move <= length; move += step)
+		constraints.numbers.emplace_back(tour[move - 1], move);
+	return constraints;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	TourConstraints closedFromCorner;
+	closedFromCorner.type = TourType::Closed;
+	closedFromCorner.numbers = { { 0, 1 } };
+	bool ok = race<5, 5>("closed_from_a1", closedFromCorner, SatStatus::Unsatisfiable);
+	ok &= race<6, 6>("closed_from_a1", closedFromCorner, SatStatus::Satisfiable);
+	ok &= race<8, 8>("closed_from_a1", closedFromCorner, SatStatus::Satisfiable);
+
+	TourConstraints openFromCorner;
+	openFromCorner.numbers = { { 0, 1 } };
+	ok &= race<8, 8>("open_from_a1", openFromCorner, SatStatus::Satisfiable);
+
+	ok &= race<6, 6>("every_6th_number", numbered_puzzle<6, 6>(0, 6, 1), SatStatus::Satisfiable);
+	ok &= race<8, 8>("every_8th_number", numbered_puzzle<8, 8>(0, 8, 1), SatStatus::Satisfiable);
+	ok &= race<8, 8>("every_16th_number", numbered_puzzle<8, 8>(27, 16, 7), SatStatus::Satisfiable);
+
+	// Moves alternate colours, so a 64 move tour from A1 ends on the other colour and never on C1.
+	TourConstraints impossible = openFromCorner;
+	impossible.numbers.emplace_back(Board<8, 8>::index(0, 2), 64);
+	ok &= race<8, 8>("ending_on_c1", impossible, SatStatus::Unsatisfiable);
+
+	// Shapes backtracking cannot represent.
+	TourConstraints corners;
+	corners.type = TourType::Closed;
+	corners.blocked = { 0, 7, 56, 63 };
+	ok &= run_sat_only<8, 8>("closed_without_corners", corners, SatStatus::Satisfiable);
+
+	TourConstraints holes;
+	holes.blocked = { Board<10, 10>::index(4, 4), Board<10, 10>::index(4, 5), Board<10, 10>::index(5, 4), Board<10, 10>::index(5, 5) };
+	holes.numbers = { { 0, 1 } };
+	ok &= run_sat_only<10, 10>("open_around_2x2_hole", holes, SatStatus::Satisfiable);
+	std::cout << "\n";
+	if(ok == false)
+		return 1;
+	return bench::run(argc, argv);
+}
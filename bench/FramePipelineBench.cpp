@@ -0,0 +1,141 @@
+// Drives FramePipeline with a fake queue, a thread that plays the GPU by sleeping through each
+// frame's work, to show how much recording and execution overlap without a real device.
+// Usage: FramePipelineBench [frames]
+//
+// Every frame takes cpuMs to record and gpuMs to execute. Flushing after every frame, what
+// Draw used to do, costs cpuMs + gpuMs per frame. With two or more frames in flight it should
+// come down to the slower of the two. Checks on the way that no slot is reused before the GPU
+// is done with it, and exits with 1 if one is.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "FramePipeline.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+// Executes submitted work in order on its own thread, and sets the fence when it reaches a
+// signal, like a command queue.
+class FakeQueue : public FrameQueue {
+public:
+	FakeQueue() : gpu([this] { run(); }) {}
+
+	~FakeQueue() override {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		changed.notify_all();
+		gpu.join();
+	}
+
+	void submit(Milliseconds work) { push({ work, 0 }); }
+	void signal(uint64_t value) override { push({ Milliseconds(0), value }); }
+	uint64_t completed_value() const override { return completed.load(); }
+
+	void wait_for(uint64_t value) override {
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait(lock, [&] { return completed.load() >= value; });
+	}
+
+private:
+	struct Command {
+		Milliseconds work;
+		uint64_t fence;		// 0 for work, otherwise the value to signal.
+	};
+
+	void push(Command command) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			commands.push_back(command);
+		}
+		changed.notify_all();
+	}
+
+	void run() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while(true) {
+			changed.wait(lock, [&] { return stopping || commands.empty() == false; });
+			if(commands.empty())
+				return;
+			Command command = commands.front();
+			commands.pop_front();
+			lock.unlock();
+			std::this_thread::sleep_for(command.work);
+			lock.lock();
+			if(command.fence != 0) {
+				completed = command.fence;
+				changed.notify_all();
+			}
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::deque<Command> commands;
+	std::atomic<uint64_t> completed{ 0 };
+	bool stopping = false;
+	std::thread gpu;
+};
+
+struct Result {
+	double msPerFrame;
+	uint64_t stalls;
+	uint64_t reusedEarly;	// Slots handed out while the GPU could still be reading them.
+};
+
+// frameCount 0 flushes after every frame instead of pipelining.
+Result run(int frameCount, int frames, double cpuMs, double gpuMs) {
+	FakeQueue queue;
+	FramePipeline pipeline(queue, frameCount > 0 ? frameCount : 1);
+	uint64_t reusedEarly = 0;
+
+	auto begin = Clock::now();
+	for(int frame = 0; frame < frames; ++frame) {
+		pipeline.begin_frame();
+		if(queue.completed_value() < pipeline.fence_value(pipeline.frame_index()))
+			++reusedEarly;
+
+		std::this_thread::sleep_for(Milliseconds(cpuMs));	// Recording.
+		queue.submit(Milliseconds(gpuMs));
+		pipeline.end_frame();
+		if(frameCount == 0)
+			pipeline.flush();
+	}
+	pipeline.flush();
+	double ms = Milliseconds(Clock::now() - begin).count();
+	return { ms / frames, pipeline.stalls(), reusedEarly };
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	const int frames = argc > 1 ? std::stoi(argv[1]) : 200;
+	bool safe = true;
+
+	const double cases[][2] = { { 2.0, 3.0 }, { 3.0, 2.0 }, { 2.0, 2.0 } };
+	for(const auto& times : cases) {
+		std::cout << "cpu " << times[0] << " ms, gpu " << times[1] << " ms per frame\n";
+		for(int frameCount : { 0, 1, 2, 3 }) {
+			Result result = run(frameCount, frames, times[0], times[1]);
+			std::cout << "  " << (frameCount == 0 ? std::string("flush every frame") : std::to_string(frameCount) + " in flight      ")
+				<< "  " << result.msPerFrame << " ms/frame, " << result.stalls << " stalls\n";
+			safe &= result.reusedEarly == 0;
+		}
+	}
+
+	if(safe == false) {
+		std::cout << "A frame slot was reused before the GPU finished with it.\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,244 @@
+// Latency and throughput of the game logic hot paths, using the harness in Benchmark.h.
+// Run with --json results.json to save a baseline and --baseline results.json to compare
+// against it later, see Benchmark.h for every option.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "BoardState.h"
+#include "Board.h"
+#include "BoardGraph.h"
+#include "KnightsTour.h"
+#include "Random.h"
+#include "Warnsdorff.h"
+
+namespace {
+
+// A full tour of the game board, so every move made below is legal.
+const std::vector<int>& game_tour() {
+	static const std::vector<int> tour = [] {
+		Warnsdorff<rows, columns>::Tour tiles{};
+		int length = Warnsdorff<rows, columns>(TieBreak::SquirrelCull).solve(0, tiles);
+		return std::vector<int>(tiles.begin(), tiles.begin() + length);
+	}();
+	return tour;
+}
+
+// Visited sets with tile i % tileCount as the knight's tile, spread over the board.
+template <int Rows, int Columns>
+std::vector<Bitboard> visited_sets() {
+	std::vector<Bitboard> sets(1024);
+	uint64_t state = 0x9E3779B97F4A7C15ull;
+	for(size_t i = 0; i < sets.size(); ++i) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		sets[i] = (state & KnightAttacks<Rows, Columns>::allTiles) | square_bit(static_cast<int>(i % (Rows * Columns)));
+	}
+	return sets;
+}
+
+// The lookup BoardState::calculate_visitable_tile does after every move.
+template <int Rows, int Columns>
+void calculate_visitable_tile(bench::State& state) {
+	std::vector<Bitboard> sets = visited_sets<Rows, Columns>();
+	size_t i = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(KnightAttacks<Rows, Columns>::visitable(static_cast<int>(i % (Rows * Columns)), sets[i & 1023]));
+		++i;
+	}
+}
+
+// Plays a whole tour, one make_move per item, starting from a cleared board.
+void make_move(bench::State& state) {
+	const std::vector<int>& tour = game_tour();
+	BoardState board;
+	state.set_items_per_iteration(tour.size());
+	for(auto _ : state) {
+		board.clear();
+		for(int tile : tour)
+			board.make_move(tile);
+		bench::do_not_optimize(board.current_move());
+	}
+}
+
+// One undo_move and the redo_move that puts the board back, at the end of a full tour.
+// They always come in pairs here so the board is the same at the start of every iteration.
+void undo_redo_move(bench::State& state) {
+	const std::vector<int>& tour = game_tour();
+	BoardState board;
+	for(int tile : tour)
+		board.make_move(tile);
+
+	state.set_items_per_iteration(2);
+	for(auto _ : state) {
+		board.undo_move();
+		bench::do_not_optimize(board.current_move());
+		board.redo_move();
+	}
+}
+
+// Copies a board after a full tour, like the searches that branch on BoardState copies. The
+// move graph is shared, so only the game state is copied.
+void board_copy(bench::State& state) {
+	BoardState board;
+	for(int tile : game_tour())
+		board.make_move(tile);
+	for(auto _ : state) {
+		BoardState copy = board;
+		bench::do_not_optimize(copy.current_move());
+	}
+}
+
+// Warnsdorff tour from the first tile replayed into the game board, what 'S' does.
+void solve_from(bench::State& state) {
+	BoardState board;
+	state.set_items_per_iteration(BoardState::tile_count());
+	int start = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(KnightsTour::solve_from(board, start));
+		start = (start + 1) % BoardState::tile_count();
+	}
+}
+
+// Jumps from the end of a history of state.range() moves back to its first move and forward
+// again, which is what moving the history cursor costs in the game.
+void history_jump(bench::State& state) {
+	const std::vector<int>& tour = game_tour();
+	int length = static_cast<int>(std::min<int64_t>(state.range(), static_cast<int64_t>(tour.size())));
+	BoardState board;
+	for(int i = 0; i < length; ++i)
+		board.make_move(tour[i]);
+
+	state.set_items_per_iteration(2 * (length - 1));
+	for(auto _ : state) {
+		while(board.current_move() > 0)
+			board.undo_move();
+		while(board.current_move() + 1 < length)
+			board.redo_move();
+		bench::do_not_optimize(board.current_move());
+	}
+}
+
+// Switches between two variations after a session of state.range() random moves, undos and
+// redos. The cost depends on how far apart the variations are, not on the session length.
+void variation_jump(bench::State& state) {
+	BoardState board;
+	SplitMix64 random(7);
+	for(int64_t move = 0; move < state.range(); ++move) {
+		Bitboard targets = board.is_first_move_made() ? board.visitable_tiles() : KnightAttacks<rows, columns>::allTiles;
+		if(targets == 0 || random.next_below(4) == 0) {
+			board.undo_move();
+			continue;
+		}
+		for(int skip = static_cast<int>(random.next_below(static_cast<uint32_t>(popcount(targets)))); skip > 0; --skip)
+			targets &= targets - 1;
+		board.make_move(lowest_square(targets));
+	}
+
+	// The deepest nodes of the first and last lines explored.
+	MoveTree::NodeId first = 1;
+	while(board.history().first_child(first) != MoveTree::none)
+		first = board.history().first_child(first);
+	MoveTree::NodeId last = static_cast<MoveTree::NodeId>(board.history().size() - 1);
+
+	state.set_items_per_iteration(2);
+	for(auto _ : state) {
+		board.jump_to(first);
+		board.jump_to(last);
+		bench::do_not_optimize(board.current_move());
+	}
+}
+
+std::vector<std::string> notation_inputs(int size) {
+	std::vector<std::string> inputs;
+	for(int64_t i = 0; i < 1024; ++i)
+		inputs.push_back(KnightsTour::index_to_chess_notation(i * 7919 % (int64_t(size) * size), size));
+	return inputs;
+}
+
+// Parses chess notation on a state.range() sized square board.
+void chess_notation_to_index(bench::State& state) {
+	int size = static_cast<int>(state.range());
+	std::vector<std::string> inputs = notation_inputs(size);
+	size_t i = 0;
+	for(auto _ : state)
+		bench::do_not_optimize(KnightsTour::chess_notation_to_index(inputs[i++ & 1023], size, size));
+}
+
+void index_to_chess_notation(bench::State& state) {
+	int64_t size = state.range();
+	int64_t tiles = size * size;
+	int64_t i = 0;
+	for(auto _ : state) {
+		std::string notation = KnightsTour::index_to_chess_notation(i * 7919 % tiles, static_cast<int>(size));
+		bench::do_not_optimize(notation.size());
+		++i;
+	}
+}
+
+// Full Warnsdorff tours on the bitboard solver, one item per tile.
+template <int Rows, int Columns>
+void warnsdorff(bench::State& state) {
+	using Solver = Warnsdorff<Rows, Columns>;
+	Solver solver(TieBreak::SquirrelCull);
+	typename Solver::Tour tour{};
+	state.set_items_per_iteration(Solver::tileCount);
+	int start = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(solver.solve(start, tour));
+		start = (start + 1) % Solver::tileCount;
+	}
+}
+
+// Full Warnsdorff tours on a state.range() sized DynamicBoard, one item per tile.
+void warnsdorff_dynamic(bench::State& state) {
+	int size = static_cast<int>(state.range());
+	DynamicBoard board(size, size);
+	std::vector<uint32_t> tour;
+	state.set_items_per_iteration(board.tile_count());
+	int start = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(warnsdorff_tour(board, start, tour, TieBreak::SquirrelCull));
+		start = (start + 1) % board.tile_count();
+	}
+}
+
+// Same tours on the compiled move graph of the board, where every tile's moves are a short
+// list instead of eight offset checks.
+void warnsdorff_graph(bench::State& state) {
+	int size = static_cast<int>(state.range());
+	BoardGraph board(BoardShape::rectangle(size, size));
+	std::vector<uint32_t> tour;
+	state.set_items_per_iteration(board.tile_count());
+	int start = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(warnsdorff_tour(board, start, tour, TieBreak::SquirrelCull));
+		start = (start + 1) % board.tile_count();
+	}
+}
+
+}
+
+BENCHMARK(make_move);
+BENCHMARK(undo_redo_move);
+BENCHMARK(board_copy);
+BENCHMARK(solve_from);
+BENCHMARK(history_jump).Arg(8).Arg(32).Arg(64);
+BENCHMARK(variation_jump).Arg(1000).Arg(1000000);
+BENCHMARK(chess_notation_to_index).Arg(8).Arg(26).Arg(1000);
+BENCHMARK(index_to_chess_notation).Arg(8).Arg(26).Arg(1000);
+BENCHMARK(warnsdorff_dynamic).Arg(8).Arg(16).Arg(100);
+BENCHMARK(warnsdorff_graph).Arg(8).Arg(16).Arg(100);
+
+int main(int argc, char* argv[]) {
+	// Board sizes fixed at compile time are registered by hand.
+	bench::register_benchmark("calculate_visitable_tile/5x5", calculate_visitable_tile<5, 5>);
+	bench::register_benchmark("calculate_visitable_tile/6x6", calculate_visitable_tile<6, 6>);
+	bench::register_benchmark("calculate_visitable_tile/8x8", calculate_visitable_tile<8, 8>);
+	bench::register_benchmark("warnsdorff/6x6", warnsdorff<6, 6>);
+	bench::register_benchmark("warnsdorff/8x8", warnsdorff<8, 8>);
+	return bench::run(argc, argv);
+}
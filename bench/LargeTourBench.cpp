@@ -0,0 +1,89 @@
+// Builds divide and conquer closed tours, checks them and times building and streaming them
+// with the harness in Benchmark.h.
+// Usage: LargeTourBench [--write file] [options of Benchmark.h]
+//
+// --write saves the 1000x1000 tour to file. Exits with 1 if a tour is not a closed knight's tour.
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "LargeTour.h"
+
+namespace {
+
+// Walks the tour once and checks it visits every tile exactly once with knight moves only
+// and ends a knight's move away from the start.
+bool check(const LargeTour& tour) {
+	std::vector<bool> visited(static_cast<size_t>(tour.tile_count()), false);
+	int64_t previous = -1;
+	int64_t count = 0;
+	bool valid = true;
+	auto is_knight_move = [&](int64_t from, int64_t to) {
+		int64_t rowDelta = from / tour.columns() - to / tour.columns();
+		int64_t columnDelta = from % tour.columns() - to % tour.columns();
+		return rowDelta * rowDelta + columnDelta * columnDelta == 5;
+	};
+
+	tour.for_each_tile([&](int64_t index) {
+		if(visited[index] || (previous >= 0 && is_knight_move(previous, index) == false))
+			valid = false;
+		visited[index] = true;
+		previous = index;
+		++count;
+	});
+
+	return valid && count == tour.tile_count() && is_knight_move(previous, 0);
+}
+
+// Items are tiles, so items/s is the streaming rate.
+void walk(bench::State& state) {
+	LargeTour tour(static_cast<int>(state.range()), static_cast<int>(state.range()));
+	state.set_items_per_iteration(tour.tile_count());
+	for(auto _ : state) {
+		int64_t checksum = 0;
+		tour.for_each_tile([&](int64_t index) { checksum += index; });
+		bench::do_not_optimize(checksum);
+	}
+}
+
+void build(bench::State& state) {
+	for(auto _ : state)
+		bench::do_not_optimize(LargeTour(static_cast<int>(state.range()), static_cast<int>(state.range())).tile_count());
+}
+
+}
+
+BENCHMARK(walk).Arg(100).Arg(1000);
+BENCHMARK(build).Arg(1000).Arg(LargeTour::maxDimension);
+
+int main(int argc, char* argv[]) {
+	// Every block combination on small and medium boards.
+	int failures = 0;
+	for(int rows = 6; rows <= 40; rows += 2) {
+		for(int columns = 6; columns <= 40; columns += 2) {
+			if(check(LargeTour(rows, columns)) == false) {
+				std::cout << "Invalid tour on " << rows << "x" << columns << "\n";
+				++failures;
+			}
+		}
+	}
+	std::cout << "6x6 to 40x40: " << (failures == 0 ? "all tours valid" : "failures found") << "\n";
+
+	LargeTour tour(1000, 1000);
+	const bool valid = check(tour);
+	std::cout << "1000x1000: " << (valid ? "valid" : "INVALID") << "\n\n";
+	if(failures != 0 || valid == false)
+		return 1;
+
+	if(argc > 2 && std::strcmp(argv[1], "--write") == 0) {
+		std::ofstream out(argv[2], std::ios::binary);
+		tour.write(out);
+		argv[2] = argv[0];
+		return bench::run(argc - 2, argv + 2);
+	}
+	return bench::run(argc, argv);
+}
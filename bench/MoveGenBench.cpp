@@ -0,0 +1,149 @@
+// Compares the string based visitable tile calculation KnightsTour used to do with the
+// bitboard lookup from Bitboard.h. Has no DirectX dependency so it builds anywhere.
+// Takes the options of Benchmark.h.
+//
+// First checks that both versions agree on every input and exits with 1 if not.
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+#include "Bitboard.h"
+
+namespace {
+
+constexpr int rows = 8;
+constexpr int columns = 8;
+
+// String round trip version, kept as the baseline.
+bool is_valid_letter(char letter) {
+	return ((int)letter >= 65 && (int)letter <= 72) || ((int)letter >= 97 && (int)letter <= 104);
+}
+
+bool is_valid_number(char number) {
+	return ((int)number >= 49 && (int)number <= 56);
+}
+
+int chess_notation_to_index(const std::string& input) {
+	char letter = input[0];
+	if((int)letter >= 97 && (int)letter <= 122)
+		letter = (int)letter - 32;
+	char number = input[1];
+	return rows * ((int)number - 49) + ((int)letter - 65);
+}
+
+std::string index_to_chess_notation(int index) {
+	std::string result {};
+	result.push_back((char)((index % columns) + 65));
+	result.push_back((char)(int(index / rows) + 49));
+	return result;
+}
+
+int string_visitable(int index, const std::array<bool, 64>& visited, std::array<bool, 64>& visitable) {
+	constexpr int letterOffsets[8] = { -1, 1, -2, 2, -2, 2, -1, 1 };
+	constexpr int numberOffsets[8] = { -2, -2, -1, -1, 1, 1, 2, 2 };
+
+	visitable.fill(false);
+	std::string chessNotation = index_to_chess_notation(index);
+	int letter = chessNotation[0];
+	int number = chessNotation[1];
+
+	int count = 0;
+	for(int i = 0; i < 8; ++i) {
+		if(is_valid_letter(letter + letterOffsets[i]) && is_valid_number(number + numberOffsets[i])) {
+			std::string tile {};
+			tile.push_back((char)(letter + letterOffsets[i]));
+			tile.push_back((char)(number + numberOffsets[i]));
+			int tileIndex = chess_notation_to_index(tile);
+			if(visited.at(tileIndex) == false) {
+				visitable.at(tileIndex) = true;
+				++count;
+			}
+		}
+	}
+	return count;
+}
+
+// Deterministic pseudo random visited sets so both versions see the same input.
+uint64_t next_random(uint64_t& state) {
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+constexpr int inputCount = 1024;
+
+// Random visited sets, as bitboards and as the bool arrays the string version takes.
+struct Inputs {
+	std::array<Bitboard, inputCount> visitedSets {};
+	std::array<std::array<bool, 64>, inputCount> visitedArrays {};
+
+	Inputs() {
+		uint64_t state = 0x9E3779B97F4A7C15ull;
+		for(auto& visited : visitedSets)
+			visited = next_random(state) & next_random(state);
+		for(int i = 0; i < inputCount; ++i)
+			for(int tile = 0; tile < 64; ++tile)
+				visitedArrays[i][tile] = (visitedSets[i] & square_bit(tile)) != 0;
+	}
+};
+
+const Inputs& inputs() {
+	static const Inputs instance;
+	return instance;
+}
+
+// Both versions must agree before timing means anything.
+bool check_agreement() {
+	const Inputs& input = inputs();
+	std::array<bool, 64> visitable {};
+	for(int i = 0; i < inputCount; ++i) {
+		int tile = i % 64;
+		int expected = string_visitable(tile, input.visitedArrays[i], visitable);
+		Bitboard result = KnightAttacks<rows, columns>::visitable(tile, input.visitedSets[i]);
+		if(popcount(result) != expected) {
+			std::cout << "Mismatch on tile " << tile << "\n";
+			return false;
+		}
+		for(int target = 0; target < 64; ++target) {
+			if(visitable[target] != ((result & square_bit(target)) != 0)) {
+				std::cout << "Mismatch on tile " << tile << " target " << target << "\n";
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void string_round_trip(bench::State& state) {
+	const Inputs& input = inputs();
+	std::array<bool, 64> visitable {};
+	int i = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(string_visitable(i % 64, input.visitedArrays[i % inputCount], visitable));
+		++i;
+	}
+}
+
+void bitboard(bench::State& state) {
+	const Inputs& input = inputs();
+	int i = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(KnightAttacks<rows, columns>::degree(i % 64, input.visitedSets[i % inputCount]));
+		++i;
+	}
+}
+
+}
+
+BENCHMARK(string_round_trip);
+BENCHMARK(bitboard);
+
+int main(int argc, char* argv[]) {
+	if(check_agreement() == false)
+		return 1;
+	return bench::run(argc, argv);
+}
@@ -0,0 +1,83 @@
+// Counts 6x6 closed tours with the parallel search, reporting per-thread work once and timing
+// every power of two thread count up to the hardware's with the harness in Benchmark.h (see
+// there for the options).
+// First checks maxTours on the 304 open 5x5 tours from a corner: a limit of exactly 304
+// completes, 303 is reported as truncated, and the tour count always matches the tours
+// handed to the callback. Exits with 1 if not.
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "Benchmark.h"
+#include "ParallelSearch.h"
+
+namespace {
+
+constexpr uint64_t cornerTours5x5 = 304;
+
+bool check_tour_limit(bool deterministic, uint64_t maxTours) {
+	ParallelOptions options;
+	options.threads = 4;
+	options.deterministic = deterministic;
+	options.limits.maxTours = maxTours;
+	std::atomic<uint64_t> delivered{ 0 };
+	ParallelStats stats = ParallelSearch<5, 5>(TourType::Open, options).enumerate(0, [&](int, const auto&) {
+		++delivered;
+		return true;
+	});
+
+	const bool wantCompleted = maxTours >= cornerTours5x5;
+	bool ok = stats.tours == std::min(maxTours, cornerTours5x5) && stats.completed == wantCompleted;
+	// Deterministic tasks each get the full limit, so only the merged count is cut.
+	ok &= deterministic || stats.tours == delivered;
+	if(ok == false)
+		std::cout << (deterministic ? "deterministic" : "shared") << " maxTours " << maxTours << ": " << stats.tours
+			<< " tours, " << delivered << " delivered, completed " << stats.completed << "\n";
+	return ok;
+}
+
+ParallelOptions count_options(int threads) {
+	ParallelOptions options;
+	options.threads = threads;
+	options.splitDepth = 4;
+	options.deterministic = true;
+	return options;
+}
+
+// Items are nodes, so items/s is the search rate over all threads.
+void count(bench::State& state) {
+	ParallelSearch<6, 6> search(TourType::Closed, count_options(static_cast<int>(state.range())));
+	uint64_t nodes = 0;
+	for(auto _ : state)
+		nodes += search.count(0).nodes;
+	state.set_items_per_iteration(nodes / state.max_iterations());
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	bool limitsOk = true;
+	for(bool deterministic : { false, true }) {
+		for(uint64_t maxTours : { cornerTours5x5 - 1, cornerTours5x5, cornerTours5x5 + 1 })
+			limitsOk &= check_tour_limit(deterministic, maxTours);
+	}
+	if(limitsOk == false) {
+		std::cout << "maxTours is not applied exactly.\n";
+		return 1;
+	}
+
+	const int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	ParallelStats stats = ParallelSearch<6, 6>(TourType::Closed, count_options(maxThreads)).count(0);
+	std::cout << maxThreads << " threads: " << stats.tours << " tours, " << stats.nodes << " nodes\n";
+	for(int i = 0; i < maxThreads; ++i)
+		std::cout << "  thread " << i << ": " << stats.threadNodes[i] << " nodes, " << stats.threadTasks[i] << " tasks\n";
+	std::cout << "\n";
+
+	bench::Registration& scaling = bench::register_benchmark("count/6x6/closed/threads", count);
+	for(int threads = 1; threads <= maxThreads; threads *= 2)
+		scaling.Arg(threads);
+	return bench::run(argc, argv);
+}
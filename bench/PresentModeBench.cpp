@@ -0,0 +1,168 @@
+// Runs the present mode state machine and click to photon latency tracking against a simulated
+// display, so both can be checked without a swap chain.
+// Usage: PresentModeBench [seconds per run]
+//
+// The simulated frame loop reads input when a frame starts, spends cpuMs recording it and
+// gpuMs rendering it, and shows it on a 60 Hz display the way DXGI does in each mode:
+//  - vsync: a frame per vertical blank, Present blocks once three frames are queued,
+//  - uncapped: blocks only on the GPU, the newest finished frame is shown at the next vertical blank,
+//  - tearing: shown as soon as it is rendered,
+//  - waitable: like vsync, but the frame waits before reading input until fewer than the
+//    maximum latency are queued.
+// Clicks arrive every 20 to 60 ms and go through LatencyTracker like SceneRenderer's.
+//
+// First checks the transitions PresentController reports and how LatencyTracker matches
+// presents to the one reported on screen, and exits with 1 if one is wrong.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "PresentMode.h"
+#include "Random.h"
+
+namespace {
+
+constexpr double refreshMs = 1000.0 / 60.0;
+constexpr int defaultQueuedFrames = 3;	// DXGI's maximum frame latency without a waitable object.
+
+double next_vblank(double time) {
+	return std::ceil(time / refreshMs) * refreshMs;
+}
+
+bool expect(SwapChainChange got, SwapChainChange wanted, const char* what) {
+	if(got != wanted)
+		std::cout << "wrong swap chain change: " << what << "\n";
+	return got == wanted;
+}
+
+// The transitions the renderer relies on.
+bool check_transitions() {
+	bool ok = true;
+	PresentController present(true);
+	ok &= expect(present.next_mode(), SwapChainChange::None, "vsync to uncapped");
+	ok &= expect(present.next_mode(), SwapChainChange::None, "uncapped to tearing");
+	ok &= present.allow_tearing() && present.sync_interval() == 0;
+	ok &= expect(present.next_mode(), SwapChainChange::Recreate, "tearing to waitable");
+	ok &= present.waitable() && present.sync_interval() == 1;
+	ok &= expect(present.set_max_latency(2), SwapChainChange::SetLatency, "latency change while waitable");
+	ok &= expect(present.set_max_latency(2), SwapChainChange::None, "same latency");
+	ok &= expect(present.next_mode(), SwapChainChange::Recreate, "waitable to vsync");
+	ok &= expect(present.set_max_latency(1), SwapChainChange::None, "latency change while not waitable");
+
+	PresentController noTearing(false, PresentMode::Tearing);
+	ok &= noTearing.mode() == PresentMode::Uncapped && noTearing.allow_tearing() == false;
+	ok &= noTearing.requested_mode() == PresentMode::Tearing;
+	ok &= PresentController(true, PresentMode::Waitable, 100).max_latency() == PresentController::maxFrameLatency;
+	if(ok == false)
+		std::cout << "PresentController transitions are wrong.\n";
+	return ok;
+}
+
+// Only the present the display reports gets a latency, earlier ones are dropped.
+bool check_tracker() {
+	LatencyTracker tracker;
+	tracker.input(1.0);
+	tracker.presented(1, PresentMode::VSync);
+	tracker.input(2.0);
+	tracker.input(2.5);
+	tracker.presented(2, PresentMode::VSync);
+	tracker.presented(3, PresentMode::VSync);	// No input before it, so no sample.
+	tracker.displayed(2, 4.0);
+	tracker.displayed(2, 4.0);	// Reported again on the next frame.
+
+	const LatencyTracker::Stats& stats = tracker.stats(PresentMode::VSync);
+	bool ok = stats.samples == 1 && stats.last == 2.0 && tracker.unmeasured() == 1 && tracker.pending() == 0;
+	if(ok == false)
+		std::cout << "LatencyTracker matched presents wrongly.\n";
+	return ok;
+}
+
+struct RunResult {
+	double fps;
+	LatencyTracker::Stats latency;
+};
+
+RunResult simulate(const PresentController& present, double cpuMs, double gpuMs, double seconds) {
+	LatencyTracker tracker;
+	SplitMix64 random(7);
+	double nextClick = 20.0;
+	auto click_gap = [&] { return 20.0 + static_cast<double>(random.next() % 4000) / 100.0; };
+
+	const PresentMode mode = present.mode();
+	const int queued = present.waitable() ? present.max_latency() : defaultQueuedFrames;
+	std::vector<double> rendered;	// When the GPU finished every frame so far.
+	std::vector<double> shown;		// Display time of every frame so far.
+	double cpuFree = 0.0;
+	double gpuFree = 0.0;
+	const double end = seconds * 1000.0;
+
+	while(cpuFree < end) {
+		const size_t frame = shown.size();
+		double start = cpuFree;
+		if(mode == PresentMode::Waitable && frame >= static_cast<size_t>(queued))
+			start = std::max(start, shown[frame - queued]);
+
+		// Input is read when the frame starts.
+		while(nextClick <= start) {
+			tracker.input(nextClick);
+			nextClick += click_gap();
+		}
+
+		double presentTime = start + cpuMs;
+		const double done = std::max(presentTime, gpuFree) + gpuMs;
+		gpuFree = done;
+		rendered.push_back(done);
+
+		// Present blocks while too many frames wait for the GPU, or for the display with vsync.
+		if(frame >= static_cast<size_t>(queued))
+			presentTime = std::max(presentTime, rendered[frame - queued]);
+		double display = done;
+		if(mode == PresentMode::VSync || mode == PresentMode::Waitable) {
+			display = next_vblank(done);
+			if(frame > 0)
+				display = std::max(display, shown[frame - 1] + refreshMs);
+			if(mode == PresentMode::VSync && frame >= static_cast<size_t>(queued))
+				presentTime = std::max(presentTime, shown[frame - queued]);
+		}
+		else if(mode == PresentMode::Uncapped)
+			display = next_vblank(done);
+		shown.push_back(display);
+
+		tracker.presented(frame + 1, mode);
+		tracker.displayed(frame + 1, display);
+		cpuFree = presentTime;
+	}
+	return { shown.size() / seconds, tracker.stats(mode) };
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	const double seconds = argc > 1 ? std::stod(argv[1]) : 20.0;
+	if(check_transitions() == false || check_tracker() == false)
+		return 1;
+
+	const double cases[][2] = { { 2.0, 3.0 }, { 4.0, 10.0 } };
+	for(const auto& times : cases) {
+		std::cout << "cpu " << times[0] << " ms, gpu " << times[1] << " ms per frame, 60 Hz display\n";
+		PresentController present(true);
+		for(int step = 0; step < presentModeCount + 2; ++step) {
+			RunResult result = simulate(present, times[0], times[1], seconds);
+			std::string name = present_mode_name(present.mode());
+			if(present.waitable())
+				name += ", max latency " + std::to_string(present.max_latency());
+			std::cout << "  " << name << ": " << result.fps << " fps, click to photon " << result.latency.mean() << " ms mean, "
+				<< result.latency.min << " min, " << result.latency.max << " max (" << result.latency.samples << " clicks)\n";
+
+			// Walk through the modes, then the latencies of waitable mode.
+			if(present.waitable())
+				present.set_max_latency(present.max_latency() + 1);
+			else
+				present.next_mode();
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,115 @@
+// Samples random walks with TourSampler, checks that the results do not depend on the thread
+// count and compares Knuth's tour count estimate with exact counts on small boards, then times
+// sampling on one thread with the harness in Benchmark.h (see there for the options).
+//
+// Exits with 1 if a result changes with the thread count, or if the weighted tours from
+// sample_tours do not match the statistics of the same walks.
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+#include "TourSampler.h"
+
+namespace {
+
+template <int TileCount>
+bool same(const SampleStats<TileCount>& a, const SampleStats<TileCount>& b) {
+	return a.samples == b.samples && a.fullTours == b.fullTours && a.closedTours == b.closedTours &&
+		a.endSquares == b.endSquares && a.lengths == b.lengths && a.estimatedTours == b.estimatedTours;
+}
+
+// Whether tiles visits every tile once with knight moves.
+template <int Rows, int Columns, typename Tiles>
+bool is_tour(const Tiles& tiles) {
+	Bitboard visited = square_bit(tiles[0]);
+	for(size_t i = 1; i < tiles.size(); ++i) {
+		if((KnightAttacks<Rows, Columns>::table[tiles[i - 1]] & square_bit(tiles[i])) == 0)
+			return false;
+		visited |= square_bit(tiles[i]);
+	}
+	return visited == KnightAttacks<Rows, Columns>::allTiles;
+}
+
+constexpr uint64_t checkedSamples = 200000;
+constexpr uint64_t samplesPerIteration = 8192;
+
+template <int Rows, int Columns>
+bool check(BatchPolicy policy, int start) {
+	SamplerOptions options;
+	options.seed = 2024;
+	options.policy = policy;
+	options.threads = 1;
+	auto single = TourSampler<Rows, Columns>(options).sample(start, checkedSamples);
+
+	options.threads = 7;
+	auto many = TourSampler<Rows, Columns>(options).sample(start, checkedSamples);
+
+	int longest = Rows * Columns;
+	while(longest > 0 && single.lengths[longest] == 0)
+		--longest;
+	int commonEnd = 0;
+	for(int i = 1; i < Rows * Columns; ++i) {
+		if(single.endSquares[i] > single.endSquares[commonEnd])
+			commonEnd = i;
+	}
+
+	std::cout << Rows << "x" << Columns << (policy == BatchPolicy::Uniform ? " uniform" : " warnsdorff")
+		<< " from " << start << ": " << single.fullTours << " tours (" << single.closedTours << " closed) in "
+		<< checkedSamples << " walks, longest walk " << longest << ", most common end " << commonEnd
+		<< ", estimated tours " << single.estimatedTours
+		<< (same(single, many) ? ", same with 7 threads\n" : ", DIFFERS with 7 threads\n");
+	if(same(single, many) == false)
+		return false;
+
+	// The same walks again, keeping their tours. Weights are summed in sample order where the
+	// statistics sum them per chunk, so only compare within rounding.
+	options.threads = 1;
+	auto tours = TourSampler<Rows, Columns>(options).sample_tours(start, checkedSamples);
+	options.threads = 7;
+	auto manyTours = TourSampler<Rows, Columns>(options).sample_tours(start, checkedSamples);
+	bool toursMatch = tours.size() == single.fullTours && manyTours.size() == tours.size();
+	double weights = 0.0;
+	for(size_t i = 0; toursMatch && i < tours.size(); ++i) {
+		toursMatch &= tours[i].sample == manyTours[i].sample && tours[i].tiles == manyTours[i].tiles && tours[i].weight == manyTours[i].weight;
+		toursMatch &= tours[i].tiles[0] == start && is_tour<Rows, Columns>(tours[i].tiles);
+		weights += tours[i].weight;
+	}
+	if(policy == BatchPolicy::Uniform)
+		toursMatch &= std::abs(weights / checkedSamples - single.estimatedTours) <= 1e-9 * single.estimatedTours;
+	if(toursMatch == false)
+		std::cout << "  sample_tours does not match sample\n";
+	return toursMatch;
+}
+
+// Items are walks, so items/s is the walk rate of one thread.
+template <int Rows, int Columns, BatchPolicy Policy>
+void sample(bench::State& state) {
+	SamplerOptions options;
+	options.policy = Policy;
+	options.threads = 1;
+	TourSampler<Rows, Columns> sampler(options);
+	state.set_items_per_iteration(samplesPerIteration);
+	for(auto _ : state)
+		bench::do_not_optimize(sampler.sample(0, samplesPerIteration).fullTours);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	// Exact counts: 304 open tours from a 5x5 corner, 524486 from a 6x6 corner.
+	bool ok = check<5, 5>(BatchPolicy::Uniform, 0);
+	ok &= check<6, 6>(BatchPolicy::Uniform, 0);
+	ok &= check<8, 8>(BatchPolicy::Uniform, 0);
+	ok &= check<8, 8>(BatchPolicy::Warnsdorff, 0);
+	std::cout << "\n";
+	if(ok == false)
+		return 1;
+
+	bench::register_benchmark("sample/5x5/uniform", sample<5, 5, BatchPolicy::Uniform>);
+	bench::register_benchmark("sample/6x6/uniform", sample<6, 6, BatchPolicy::Uniform>);
+	bench::register_benchmark("sample/8x8/uniform", sample<8, 8, BatchPolicy::Uniform>);
+	bench::register_benchmark("sample/8x8/warnsdorff", sample<8, 8, BatchPolicy::Warnsdorff>);
+	return bench::run(argc, argv);
+}
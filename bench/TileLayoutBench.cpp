@@ -0,0 +1,142 @@
+// Compares the old array of Tile structs, with render data mixed into the game state, against
+// the parallel arrays BoardState uses now, on boards from 8x8 up to 1000x1000.
+//
+// "scan" reads the state of every tile, like print_chessboard or refreshing tile colours.
+// "update" visits random tiles and refreshes their knight neighbourhoods, like make_move.
+// Both touch the same logical data. The bytes per tile printed first is what has to come
+// through the cache for a scan. Once the board outgrows the caches that ratio is roughly
+// the ratio of cache misses, and it shows up directly in the time per tile.
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Bitboard.h"
+#include "Board.h"
+#include "Random.h"
+
+namespace {
+
+// Tile as it was before the split: game state next to a world matrix, position and colour.
+struct InterleavedTile {
+	int index;
+	bool isVisited;
+	bool isVisitable;
+	int visitedOnMoveNo;
+	float worldMatrix[16];
+	float position[4];
+	float color[4];
+};
+
+struct InterleavedBoard {
+	std::vector<InterleavedTile> tiles;
+
+	explicit InterleavedBoard(size_t count) : tiles(count) {}
+
+	bool visited(size_t index) const { return tiles[index].isVisited; }
+	bool visitable(size_t index) const { return tiles[index].isVisitable; }
+	void set_visited(size_t index, int move) {
+		tiles[index].isVisited = true;
+		tiles[index].visitedOnMoveNo = move;
+	}
+	void set_visitable(size_t index, bool value) { tiles[index].isVisitable = value; }
+
+	// Sum of the move numbers of visited tiles plus one per visitable tile.
+	int64_t scan() const {
+		int64_t sum = 0;
+		for(const InterleavedTile& tile : tiles) {
+			if(tile.isVisited)
+				sum += tile.visitedOnMoveNo;
+			else if(tile.isVisitable)
+				++sum;
+		}
+		return sum;
+	}
+};
+
+// Bit arrays for the flags and 16 bit move numbers, the layout BoardState uses.
+struct SplitBoard {
+	std::vector<uint64_t> visitedBits;
+	std::vector<uint64_t> visitableBits;
+	std::vector<uint16_t> moveNumbers;
+
+	explicit SplitBoard(size_t count) : visitedBits((count + 63) / 64), visitableBits((count + 63) / 64), moveNumbers(count) {}
+
+	bool visited(size_t index) const { return (visitedBits[index >> 6] >> (index & 63)) & 1; }
+	bool visitable(size_t index) const { return (visitableBits[index >> 6] >> (index & 63)) & 1; }
+	void set_visited(size_t index, int move) {
+		visitedBits[index >> 6] |= uint64_t(1) << (index & 63);
+		moveNumbers[index] = static_cast<uint16_t>(move);
+	}
+	void set_visitable(size_t index, bool value) {
+		uint64_t bit = uint64_t(1) << (index & 63);
+		visitableBits[index >> 6] = value ? visitableBits[index >> 6] | bit : visitableBits[index >> 6] & ~bit;
+	}
+
+	// Same result as InterleavedBoard::scan, 64 tiles per flag word.
+	int64_t scan() const {
+		int64_t sum = 0;
+		for(size_t word = 0; word < visitedBits.size(); ++word) {
+			for(uint64_t bits = visitedBits[word]; bits; bits &= bits - 1)
+				sum += moveNumbers[word * 64 + lowest_square(bits)];
+			sum += popcount(visitableBits[word] & ~visitedBits[word]);
+		}
+		return sum;
+	}
+};
+
+// Marks a pseudo random third of the tiles visited and a sixth visitable.
+template <typename Layout>
+void fill(Layout& board, size_t count) {
+	SplitMix64 random(3);
+	for(size_t i = 0; i < count; ++i) {
+		uint32_t roll = random.next_below(6);
+		if(roll < 2)
+			board.set_visited(i, static_cast<int>(i % 60000) + 1);
+		else if(roll == 2)
+			board.set_visitable(i, true);
+	}
+}
+
+template <typename Layout>
+void scan(bench::State& state) {
+	size_t count = static_cast<size_t>(state.range()) * static_cast<size_t>(state.range());
+	Layout board(count);
+	fill(board, count);
+
+	state.set_items_per_iteration(count);
+	for(auto _ : state)
+		bench::do_not_optimize(board.scan());
+}
+
+template <typename Layout>
+void update(bench::State& state) {
+	int size = static_cast<int>(state.range());
+	DynamicBoard shape(size, size);
+	size_t count = static_cast<size_t>(shape.tile_count());
+	Layout board(count);
+	fill(board, count);
+
+	SplitMix64 random(5);
+	int move = 1;
+	for(auto _ : state) {
+		int index = static_cast<int>(random.next_below(static_cast<uint32_t>(count)));
+		board.set_visited(index, move++);
+		shape.for_each_move(index, [&](int target) { board.set_visitable(target, board.visited(target) == false); });
+		bench::do_not_optimize(board.visitable(index));
+	}
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::cout << "Bytes per tile for a scan: interleaved " << sizeof(InterleavedTile)
+		<< ", split " << 2.0 / 8 + sizeof(uint16_t) << "\n\n";
+
+	bench::register_benchmark("scan/interleaved", scan<InterleavedBoard>).Arg(8).Arg(100).Arg(1000);
+	bench::register_benchmark("scan/split", scan<SplitBoard>).Arg(8).Arg(100).Arg(1000);
+	bench::register_benchmark("update/interleaved", update<InterleavedBoard>).Arg(8).Arg(100).Arg(1000);
+	bench::register_benchmark("update/split", update<SplitBoard>).Arg(8).Arg(100).Arg(1000);
+	return bench::run(argc, argv);
+}
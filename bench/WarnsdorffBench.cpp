@@ -0,0 +1,122 @@
+// Reports the success rate of each tie-breaking strategy, then times Warnsdorff tours with the
+// harness in Benchmark.h (see there for the options).
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Board.h"
+#include "Warnsdorff.h"
+
+namespace {
+
+struct Strategy {
+	TieBreak tieBreak;
+	const char* name;
+};
+
+constexpr Strategy strategies[] = {
+	{ TieBreak::FirstFound, "first_found" },
+	{ TieBreak::Pohl, "pohl" },
+	{ TieBreak::SquirrelCull, "squirrel_cull" },
+	{ TieBreak::Random, "random" },
+};
+
+template <int Rows, int Columns>
+void print_success(int rounds) {
+	using Solver = Warnsdorff<Rows, Columns>;
+	typename Solver::Tour tour{};
+	for(const Strategy& strategy : strategies) {
+		Solver solver(strategy.tieBreak, 42);
+		long long tours = 0;
+		long long fullTours = 0;
+		for(int round = 0; round < rounds; ++round) {
+			for(int square = 0; square < Solver::tileCount; ++square) {
+				if(solver.solve(square, tour) == Solver::tileCount)
+					++fullTours;
+				++tours;
+			}
+		}
+		std::cout << Rows << "x" << Columns << " " << strategy.name << ": " << (100.0 * fullTours / tours) << "% complete\n";
+	}
+}
+
+// Same rule on the generic board types, for sizes a bitboard cannot hold.
+template <typename BoardType>
+void print_generic_success(const BoardType& board, int tours) {
+	std::vector<uint32_t> tour;
+	long long fullTours = 0;
+	for(int round = 0; round < tours; ++round) {
+		if(warnsdorff_tour(board, round % board.tile_count(), tour, TieBreak::SquirrelCull) == board.tile_count())
+			++fullTours;
+	}
+	std::cout << board.rows() << "x" << board.columns() << " generic squirrel_cull: " << (100.0 * fullTours / tours) << "% complete\n";
+}
+
+template <int... Sizes>
+void print_compile_time_success(int tours) {
+	(print_generic_success(Board<Sizes, Sizes>{}, tours), ...);
+}
+
+// One tour per iteration, from every square in turn.
+template <int Rows, int Columns, TieBreak Rule>
+void solve(bench::State& state) {
+	using Solver = Warnsdorff<Rows, Columns>;
+	Solver solver(Rule, 42);
+	typename Solver::Tour tour{};
+	int square = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(solver.solve(square, tour));
+		square = square + 1 == Solver::tileCount ? 0 : square + 1;
+	}
+}
+
+template <int Rows, int Columns>
+void register_strategies() {
+	const std::string size = std::to_string(Rows) + "x" + std::to_string(Columns);
+	bench::register_benchmark("warnsdorff/" + size + "/first_found", solve<Rows, Columns, TieBreak::FirstFound>);
+	bench::register_benchmark("warnsdorff/" + size + "/pohl", solve<Rows, Columns, TieBreak::Pohl>);
+	bench::register_benchmark("warnsdorff/" + size + "/squirrel_cull", solve<Rows, Columns, TieBreak::SquirrelCull>);
+	bench::register_benchmark("warnsdorff/" + size + "/random", solve<Rows, Columns, TieBreak::Random>);
+}
+
+template <typename BoardType>
+void generic(const BoardType& board, bench::State& state) {
+	std::vector<uint32_t> tour;
+	int square = 0;
+	for(auto _ : state) {
+		bench::do_not_optimize(warnsdorff_tour(board, square, tour, TieBreak::SquirrelCull));
+		square = square + 1 == board.tile_count() ? 0 : square + 1;
+	}
+}
+
+template <int... Sizes>
+void register_compile_time_sizes() {
+	(bench::register_benchmark("generic/" + std::to_string(Sizes) + "x" + std::to_string(Sizes),
+		[](bench::State& state) { generic(Board<Sizes, Sizes>{}, state); }), ...);
+}
+
+// Side lengths a bitboard cannot hold, as DynamicBoard.
+void generic_dynamic(bench::State& state) {
+	DynamicBoard board(static_cast<int>(state.range()), static_cast<int>(state.range()));
+	generic(board, state);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	print_success<8, 8>(100);
+	print_success<6, 6>(100);
+	print_compile_time_success<5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16>(400);
+	print_generic_success(DynamicBoard(100, 100), 20);
+	print_generic_success(DynamicBoard(1000, 1000), 1);
+	std::cout << "\n";
+
+	register_strategies<8, 8>();
+	register_strategies<6, 6>();
+	register_compile_time_sizes<5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16>();
+	bench::register_benchmark("generic/dynamic", generic_dynamic).Arg(100).Arg(1000);
+	return bench::run(argc, argv);
+}
@@ -0,0 +1,415 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Bitboard.h"
+#include "TranspositionTable.h"
+
+enum class TourType {
+	Open,	// Any tour that visits every tile once.
+	Closed	// The last tile must be a knight's move away from the first one.
+};
+
+// Extra constraint on the move numbers (1 for the first tile, 2 for the second, ...).
+enum class MagicConstraint {
+	None,
+	SemiMagic,	// Every row adds up to the same sum, and so does every column.
+	Magic		// Semi-magic, and both long diagonals too. Square boards only.
+};
+
+// Optional limits so huge boards can be sampled instead of exhausted. Zero means no limit.
+struct SearchLimits {
+	uint64_t maxTours = 0;
+	uint64_t maxNodes = 0;
+};
+
+struct SearchStats {
+	uint64_t nodes = 0;			// Moves tried.
+	uint64_t tours = 0;			// Complete tours reported to the callback.
+	bool completed = true;		// False if the search stopped early because of a limit or the callback.
+	uint64_t tableProbes = 0;	// Transposition table lookups, when counting with a table.
+	uint64_t tableHits = 0;
+
+	double hit_rate() const { return tableProbes ? double(tableHits) / tableProbes : 0.0; }
+};
+
+// Exhaustive depth first tour search. Uses an explicit fixed size stack and bitboards, so
+// no memory is allocated per node. Found tours are streamed to a callback instead of stored.
+//
+// Dead ends are pruned as soon as they appear:
+//  - an unvisited tile that can no longer be entered makes the position unsolvable,
+//  - an unvisited tile with only one way in has to be the last tile of the tour, and only
+//    one tile can be last (for closed tours every tile needs two ways in and out).
+//
+// Magic constraints keep running row, column and diagonal sums. After every move each line
+// is checked against the smallest and largest totals its empty tiles could still add, so a
+// line that can no longer reach the magic sum cuts the search right away.
+template <int Rows, int Columns>
+class Backtracking {
+public:
+	using Attacks = KnightAttacks<Rows, Columns>;
+	static constexpr int tileCount = Rows * Columns;
+	using Tour = std::array<uint8_t, tileCount>;
+
+	explicit Backtracking(TourType type = TourType::Open, SearchLimits limits = {}, bool orderByDegree = false,
+		MagicConstraint magic = MagicConstraint::None)
+		: type(type), limits(limits), orderByDegree(orderByDegree), magic(magic) {}
+
+	// Calls onTour(const Tour&) for every tour starting at start. The callback returns false
+	// to stop the search.
+	template <typename Callback>
+	SearchStats enumerate(int start, Callback&& onTour) {
+		Tour prefix{};
+		prefix[0] = static_cast<uint8_t>(start);
+		return enumerate_from(prefix, 1, onTour);
+	}
+
+	// Same as enumerate, but only searches tours that begin with the first length tiles of
+	// prefix. The prefix must be a valid knight path. Used to split a search into tasks.
+	template <typename Callback>
+	SearchStats enumerate_from(const Tour& prefix, int length, Callback&& onTour) {
+		SearchStats stats;
+		Tour tour = prefix;
+		std::array<Bitboard, tileCount> candidates{};
+
+		int start = tour[0];
+		Bitboard visited = 0;
+		for(int i = 0; i < length; ++i)
+			visited |= square_bit(tour[i]);
+
+		LineSums sums{};
+		if(magic != MagicConstraint::None) {
+			if(magic_possible() == false)
+				return stats;
+			for(int i = 0; i < length; ++i)
+				sums.add(tour[i], i + 1);
+			if(sums.feasible(length, magic) == false)
+				return stats;
+		}
+
+		if(length == tileCount) {
+			if(type == TourType::Open || (Attacks::table[tour[length - 1]] & square_bit(start))) {
+				stats.tours = 1;
+				stats.completed = onTour(static_cast<const Tour&>(tour));
+			}
+			return stats;
+		}
+
+		const int base = length - 1;
+		int depth = base;	// Index in tour of the tile the knight is standing on.
+		candidates[depth] = Attacks::visitable(tour[depth], visited);
+
+		while(depth >= base) {
+			if(candidates[depth] == 0) {
+				// Nothing left to try here, step back.
+				visited &= ~square_bit(tour[depth]);
+				if(magic != MagicConstraint::None)
+					sums.remove(tour[depth], depth + 1);
+				--depth;
+				continue;
+			}
+
+			int next = pick(candidates[depth], visited);
+			candidates[depth] &= ~square_bit(next);
+
+			if(limits.maxNodes != 0 && stats.nodes >= limits.maxNodes) {
+				stats.completed = false;
+				return stats;
+			}
+			++stats.nodes;
+
+			tour[depth + 1] = static_cast<uint8_t>(next);
+			Bitboard visitedAfter = visited | square_bit(next);
+
+			if(depth + 2 == tileCount) {
+				bool closes = type == TourType::Open || (Attacks::table[next] & square_bit(start));
+				if(closes && magic != MagicConstraint::None) {
+					sums.add(next, tileCount);
+					closes = sums.feasible(tileCount, magic);
+					sums.remove(next, tileCount);
+				}
+				if(closes) {
+					++stats.tours;
+					if(onTour(static_cast<const Tour&>(tour)) == false ||
+						(limits.maxTours != 0 && stats.tours >= limits.maxTours)) {
+						stats.completed = false;
+						return stats;
+					}
+				}
+				continue;
+			}
+
+			if(is_dead_end(start, next, visitedAfter))
+				continue;
+
+			if(magic != MagicConstraint::None) {
+				sums.add(next, depth + 2);
+				if(sums.feasible(depth + 2, magic) == false) {
+					sums.remove(next, depth + 2);
+					continue;
+				}
+			}
+
+			visited = visitedAfter;
+			++depth;
+			candidates[depth] = Attacks::visitable(next, visited);
+		}
+
+		return stats;
+	}
+
+	SearchStats count(int start) {
+		return enumerate(start, [](const Tour&) { return true; });
+	}
+
+	// Counts tours like count, but remembers how many ways there are to finish from each
+	// position in table. The rest of a tour only depends on the visited tiles and the tile the
+	// knight stands on (and the start for closed tours), so a position reached again through
+	// a different move order is looked up instead of searched. Zero counts double as dead
+	// position verdicts. maxTours is ignored since whole subtrees are counted at once.
+	// Keys do not encode the board size, so only share a table between searches on one size.
+	//
+	// Magic constraints depend on the order tiles were visited in, so they fall back to the
+	// plain search.
+	SearchStats count(int start, TranspositionTable& table) {
+		Tour prefix{};
+		prefix[0] = static_cast<uint8_t>(start);
+		return count_from(prefix, 1, table);
+	}
+
+	SearchStats count_from(const Tour& prefix, int length, TranspositionTable& table) {
+		if(magic != MagicConstraint::None || length == tileCount)
+			return enumerate_from(prefix, length, [](const Tour&) { return true; });
+
+		SearchStats stats;
+		Tour tour = prefix;
+		std::array<Bitboard, tileCount> candidates{};
+		std::array<uint64_t, tileCount> counts{};		// Tours found below each depth so far.
+		std::array<uint64_t, tileCount> visitedKeys{};	// Zobrist hash of the visited set at each depth.
+
+		int start = tour[0];
+		Bitboard visited = 0;
+		uint64_t visitedKey = type == TourType::Closed ? keys.start[start] : 0;
+		for(int i = 0; i < length; ++i) {
+			visited |= square_bit(tour[i]);
+			visitedKey ^= keys.visited[tour[i]];
+		}
+
+		const int base = length - 1;
+		int depth = base;
+		candidates[depth] = Attacks::visitable(tour[depth], visited);
+		visitedKeys[depth] = visitedKey;
+
+		++stats.tableProbes;
+		if(table.probe(visitedKey ^ keys.current[tour[depth]], stats.tours)) {
+			++stats.tableHits;
+			return stats;
+		}
+
+		while(depth >= base) {
+			if(candidates[depth] == 0) {
+				// Subtree finished, so its count is exact and can be shared.
+				table.store(visitedKeys[depth] ^ keys.current[tour[depth]], counts[depth], tileCount - depth - 1);
+				visited &= ~square_bit(tour[depth]);
+				if(depth > base)
+					counts[depth - 1] += counts[depth];
+				--depth;
+				continue;
+			}
+
+			int next = pick(candidates[depth], visited);
+			candidates[depth] &= ~square_bit(next);
+
+			if(limits.maxNodes != 0 && stats.nodes >= limits.maxNodes) {
+				// Keep the tours counted so far. A subtree only adds its count to the level
+				// above once it is finished, so the partial count is spread over the open levels.
+				for(int level = base; level <= depth; ++level)
+					stats.tours += counts[level];
+				stats.completed = false;
+				return stats;
+			}
+			++stats.nodes;
+
+			tour[depth + 1] = static_cast<uint8_t>(next);
+			Bitboard visitedAfter = visited | square_bit(next);
+
+			if(depth + 2 == tileCount) {
+				if(type == TourType::Open || (Attacks::table[next] & square_bit(start)))
+					++counts[depth];
+				continue;
+			}
+
+			if(is_dead_end(start, next, visitedAfter))
+				continue;
+
+			uint64_t nextKey = visitedKeys[depth] ^ keys.visited[next];
+			uint64_t found;
+			++stats.tableProbes;
+			if(table.probe(nextKey ^ keys.current[next], found)) {
+				++stats.tableHits;
+				counts[depth] += found;
+				continue;
+			}
+
+			visited = visitedAfter;
+			++depth;
+			counts[depth] = 0;
+			visitedKeys[depth] = nextKey;
+			candidates[depth] = Attacks::visitable(next, visited);
+		}
+
+		stats.tours = counts[base];
+		return stats;
+	}
+
+private:
+	// Zobrist keys for a tile being visited, being the knight's tile, and being the start.
+	struct ZobristKeys {
+		std::array<uint64_t, tileCount> visited;
+		std::array<uint64_t, tileCount> current;
+		std::array<uint64_t, tileCount> start;
+	};
+
+	static constexpr ZobristKeys build_keys() {
+		ZobristKeys result{};
+		for(int tile = 0; tile < tileCount; ++tile) {
+			result.visited[tile] = zobrist_key(tile, 0);
+			result.current[tile] = zobrist_key(tile, 1);
+			result.start[tile] = zobrist_key(tile, 2);
+		}
+		return result;
+	}
+
+	static constexpr ZobristKeys keys = build_keys();
+
+	// Running sums and tile counts of every row, column and long diagonal.
+	struct LineSums {
+		static constexpr int total = tileCount * (tileCount + 1) / 2;
+
+		int rowSum[Rows];
+		int rowCount[Rows];
+		int columnSum[Columns];
+		int columnCount[Columns];
+		int diagonalSum[2];
+		int diagonalCount[2];
+
+		void add(int tile, int number) { update(tile, number, 1); }
+		void remove(int tile, int number) { update(tile, -number, -1); }
+
+		void update(int tile, int number, int count) {
+			int row = tile / Columns;
+			int column = tile % Columns;
+			rowSum[row] += number;
+			rowCount[row] += count;
+			columnSum[column] += number;
+			columnCount[column] += count;
+			if(row == column) {
+				diagonalSum[0] += number;
+				diagonalCount[0] += count;
+			}
+			if(row + column == Columns - 1) {
+				diagonalSum[1] += number;
+				diagonalCount[1] += count;
+			}
+		}
+
+		// Can a line with sum and filled tiles of size tiles still reach target, when the
+		// numbers left to place are last + 1 ... tileCount?
+		static bool reachable(int sum, int filled, int size, int target, int last) {
+			int empty = size - filled;
+			int smallest = empty * last + empty * (empty + 1) / 2;
+			int largest = empty * tileCount - empty * (empty - 1) / 2;
+			return sum + smallest <= target && target <= sum + largest;
+		}
+
+		bool feasible(int last, MagicConstraint magic) const {
+			for(int row = 0; row < Rows; ++row) {
+				if(reachable(rowSum[row], rowCount[row], Columns, total / Rows, last) == false)
+					return false;
+			}
+			for(int column = 0; column < Columns; ++column) {
+				if(reachable(columnSum[column], columnCount[column], Rows, total / Columns, last) == false)
+					return false;
+			}
+			if(magic == MagicConstraint::Magic) {
+				for(int i = 0; i < 2; ++i) {
+					if(reachable(diagonalSum[i], diagonalCount[i], Rows, total / Rows, last) == false)
+						return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	// Magic sums have to be whole numbers, and diagonals only exist on square boards.
+	bool magic_possible() const {
+		constexpr int total = LineSums::total;
+		if(total % Rows != 0 || total % Columns != 0)
+			return false;
+		return magic != MagicConstraint::Magic || Rows == Columns;
+	}
+
+	int pick(Bitboard candidates, Bitboard visited) const {
+		if(orderByDegree == false)
+			return lowest_square(candidates);
+
+		// Warnsdorff order finds the first tours much sooner when sampling big boards.
+		int best = -1;
+		int bestDegree = 9;
+		while(candidates) {
+			int tile = pop_lowest_square(candidates);
+			int degree = Attacks::degree(tile, visited);
+			if(degree < bestDegree) {
+				bestDegree = degree;
+				best = tile;
+			}
+		}
+		return best;
+	}
+
+	bool is_dead_end(int start, int current, Bitboard visited) const {
+		Bitboard remaining = Attacks::allTiles & ~visited;
+		Bitboard nextToCurrent = Attacks::table[current];
+
+		if(type == TourType::Closed) {
+			// The tour has to be able to get back to start at the end.
+			Bitboard nextToStart = Attacks::table[start];
+			if((nextToStart & remaining) == 0)
+				return true;
+
+			for(Bitboard tiles = remaining; tiles; ) {
+				int tile = pop_lowest_square(tiles);
+				int ways = popcount(Attacks::table[tile] & remaining) +
+					((nextToCurrent & square_bit(tile)) != 0) + ((nextToStart & square_bit(tile)) != 0);
+				if(ways < 2)
+					return true;
+			}
+			return false;
+		}
+
+		int remainingCount = popcount(remaining);
+		int forcedEnds = 0;
+		for(Bitboard tiles = remaining; tiles; ) {
+			int tile = pop_lowest_square(tiles);
+			int neighbours = popcount(Attacks::table[tile] & remaining);
+			bool reachableNow = (nextToCurrent & square_bit(tile)) != 0;
+			int ways = neighbours + reachableNow;
+			if(ways == 0)
+				return true;
+			if(ways == 1) {
+				// Only way in is the very next move, but other tiles still need visiting.
+				if(neighbours == 0 && remainingCount > 1)
+					return true;
+				if(++forcedEnds > 1)
+					return true;
+			}
+		}
+		return false;
+	}
+
+	TourType type;
+	SearchLimits limits;
+	bool orderByDegree;
+	MagicConstraint magic;
+};
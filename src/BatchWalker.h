@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "Bitboard.h"
+#include "Board.h"
+#include "Random.h"
+
+// How random walks (BatchWalker, TourSampler) pick the next tile.
+enum class BatchPolicy {
+	Warnsdorff,	// Fewest onward moves, random among ties.
+	Uniform		// Any visitable tile with equal chance.
+};
+
+struct BatchStats {
+	uint64_t walks = 0;		// Walks finished.
+	uint64_t moves = 0;		// Moves made over all walks.
+	uint64_t fullTours = 0;	// Walks that visited every tile.
+};
+
+// Advances many independent random knight walks in lockstep, for Monte Carlo sampling.
+// The state of every board is kept in parallel arrays (visited bitboard, current tile,
+// length, random state), so one step of a group of boards maps onto SIMD lanes: the knight
+// attack masks of all candidate tiles are gathered at once and their onward degrees come from
+// a vector popcount. Uses AVX-512 (with VPOPCNTDQ) or AVX2 when the compiler targets them and
+// plain loops otherwise. Every path makes exactly the same moves.
+//
+// Each step scores the up to eight knight jumps of a board as degree * 256 plus a random
+// byte (just the random byte for Uniform) and takes the lowest, so a step needs no branches.
+// Equal bytes go to the lower direction, so Uniform is only nearly uniform (see step_scalar).
+// Boards whose walk got stuck report it and start the next walk straight away.
+template <int Rows, int Columns>
+class BatchWalker {
+public:
+	using Attacks = KnightAttacks<Rows, Columns>;
+	static constexpr int tileCount = Rows * Columns;
+	static constexpr int groupSize = 8;	// Boards are handled in groups of this many.
+
+	// boards is rounded up to a multiple of groupSize. Walks start on starts in turn, or on
+	// every tile in turn when starts is empty.
+	BatchWalker(int boards, uint64_t seed, BatchPolicy policy = BatchPolicy::Warnsdorff, std::vector<int> starts = {})
+		: policy(policy), starts(std::move(starts)) {
+		boardCount = (std::max(boards, 1) + groupSize - 1) / groupSize * groupSize;
+		visited.resize(boardCount);
+		current.resize(boardCount);
+		length.resize(boardCount);
+		random.resize(boardCount);
+		start.resize(boardCount);
+
+		SplitMix64 seeds(seed);
+		for(auto& state : random)
+			state = seeds.next() | 1;	// xorshift state must not be zero.
+
+		if(this->starts.empty()) {
+			for(int tile = 0; tile < tileCount; ++tile)
+				this->starts.push_back(tile);
+		}
+		for(int d = 0; d < 8; ++d)
+			offsets[d] = knightRowOffsets[d] * Columns + knightColumnOffsets[d];
+	}
+
+	static const char* instruction_set() {
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+		return "AVX-512";
+#elif defined(__AVX2__)
+		return "AVX2";
+#else
+		return "scalar";
+#endif
+	}
+
+	int boards() const { return boardCount; }
+
+	// Runs until walks walks have finished and calls onWalk(int start, int length, int end)
+	// for each, in a fixed order for a given seed and board count.
+	template <typename Callback>
+	BatchStats run(uint64_t walks, Callback&& onWalk) {
+		BatchStats stats;
+		uint64_t started = 0;
+		for(int board = 0; board < boardCount; ++board)
+			begin_walk(board, started, walks);
+
+		while(stats.walks < walks) {
+			for(int group = 0; group < boardCount; group += groupSize) {
+				uint32_t finished = step(group);
+				while(finished) {
+					int board = group + lowest_square(finished);
+					finished &= finished - 1;
+					if(length[board] == 0)
+						continue;	// Idle, no walks left to give it.
+
+					int walkLength = static_cast<int>(length[board]);
+					stats.moves += walkLength - 1;
+					stats.fullTours += walkLength == tileCount;
+					++stats.walks;
+					onWalk(start[board], walkLength, static_cast<int>(current[board]));
+					begin_walk(board, started, walks);
+				}
+			}
+		}
+		return stats;
+	}
+
+private:
+	void begin_walk(int board, uint64_t& started, uint64_t walks) {
+		if(started == walks) {
+			// Nothing left to start. A full visited set means it never moves again.
+			visited[board] = ~Bitboard(0);
+			length[board] = 0;
+			return;
+		}
+		int tile = starts[started++ % starts.size()];
+		start[board] = tile;
+		current[board] = static_cast<uint64_t>(tile);
+		visited[board] = square_bit(tile);
+		length[board] = 1;
+	}
+
+	static uint64_t next_random(uint64_t state) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	// Moves every board of the group one step and returns a bit for each board that could not
+	// move.
+	uint32_t step(int group) {
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+		return step_avx512(group);
+#elif defined(__AVX2__)
+		return step_avx2(group) | (step_avx2(group + 4) << 4);
+#else
+		return step_scalar(group);
+#endif
+	}
+
+	// The reference every SIMD path matches move for move. Two candidates draw the same random
+	// byte with chance 1/256 and the lower direction wins the tie, so with two candidates the
+	// lower one is taken with chance 1/2 + 1/512 instead of 1/2. Sampling that needs exact
+	// uniform choices (Knuth's estimate) uses TourSampler instead.
+	uint32_t step_scalar(int group) {
+		uint32_t finished = 0;
+		for(int lane = 0; lane < groupSize; ++lane) {
+			int board = group + lane;
+			uint64_t rng = random[board] = next_random(random[board]);
+			Bitboard seen = visited[board];
+			int from = static_cast<int>(current[board]);
+			Bitboard candidates = Attacks::table[from] & ~seen;
+
+			uint64_t best = 0xFFFF;
+			int next = from;
+			for(int d = 0; d < 8; ++d) {
+				int target = from + offsets[d];
+				if(target < 0 || target >= 64 || (candidates & square_bit(target)) == 0)
+					continue;
+				uint64_t score = (rng >> (8 * d)) & 0xFF;
+				if(policy == BatchPolicy::Warnsdorff)
+					score |= static_cast<uint64_t>(popcount(Attacks::table[target] & ~seen)) << 8;
+				if(score < best) {
+					best = score;
+					next = target;
+				}
+			}
+
+			if(best == 0xFFFF) {
+				finished |= 1u << lane;
+				continue;
+			}
+			current[board] = static_cast<uint64_t>(next);
+			visited[board] = seen | square_bit(next);
+			++length[board];
+		}
+		return finished;
+	}
+
+#if defined(__AVX2__) && !(defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__))
+	// Popcount of each 64 bit lane: nibble lookup, then byte sums per lane.
+	static __m256i popcount_avx2(__m256i value) {
+		const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i low = _mm256_set1_epi8(0x0F);
+		__m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(value, low)),
+			_mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi64(value, 4), low)));
+		return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+	}
+
+	// Four boards starting at board.
+	uint32_t step_avx2(int board) {
+		const long long* table = reinterpret_cast<const long long*>(Attacks::table.data());
+		const __m256i one = _mm256_set1_epi64x(1);
+		const __m256i byte = _mm256_set1_epi64x(0xFF);
+		const __m256i none = _mm256_set1_epi64x(0xFFFF);
+
+		__m256i rng = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&random[board]));
+		rng = _mm256_xor_si256(rng, _mm256_slli_epi64(rng, 13));
+		rng = _mm256_xor_si256(rng, _mm256_srli_epi64(rng, 7));
+		rng = _mm256_xor_si256(rng, _mm256_slli_epi64(rng, 17));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&random[board]), rng);
+
+		__m256i seen = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&visited[board]));
+		__m256i from = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&current[board]));
+		__m256i candidates = _mm256_andnot_si256(seen, _mm256_i64gather_epi64(table, from, 8));
+
+		__m256i best = none;
+		__m256i next = from;
+		for(int d = 0; d < 8; ++d) {
+			__m256i target = _mm256_add_epi64(from, _mm256_set1_epi64x(offsets[d]));
+			__m256i bit = _mm256_sllv_epi64(one, target);	// Zero when target is off the bitboard.
+			__m256i valid = _mm256_cmpeq_epi64(_mm256_and_si256(candidates, bit), bit);
+			valid = _mm256_andnot_si256(_mm256_cmpeq_epi64(bit, _mm256_setzero_si256()), valid);
+
+			__m256i score = _mm256_and_si256(_mm256_srli_epi64(rng, 8 * d), byte);
+			if(policy == BatchPolicy::Warnsdorff) {
+				__m256i safeTarget = _mm256_and_si256(target, valid);
+				__m256i onward = _mm256_andnot_si256(seen, _mm256_i64gather_epi64(table, safeTarget, 8));
+				score = _mm256_or_si256(score, _mm256_slli_epi64(popcount_avx2(onward), 8));
+			}
+			score = _mm256_blendv_epi8(none, score, valid);
+
+			__m256i better = _mm256_cmpgt_epi64(best, score);
+			best = _mm256_blendv_epi8(best, score, better);
+			next = _mm256_blendv_epi8(next, target, better);
+		}
+
+		__m256i moved = _mm256_cmpgt_epi64(none, best);
+		__m256i bit = _mm256_and_si256(_mm256_sllv_epi64(one, next), moved);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&current[board]), next);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&visited[board]), _mm256_or_si256(seen, bit));
+		__m256i lengths = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&length[board]));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&length[board]), _mm256_sub_epi64(lengths, moved));
+
+		return static_cast<uint32_t>(~_mm256_movemask_pd(_mm256_castsi256_pd(moved))) & 0xF;
+	}
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+	// Eight boards starting at board.
+	// GCC's unmasked forms of several of these intrinsics pass an undefined vector through,
+	// which -Wmaybe-uninitialized reports, so the zero-masked forms with every lane set are
+	// used instead. They are the same instructions.
+	uint32_t step_avx512(int board) {
+		const long long* table = reinterpret_cast<const long long*>(Attacks::table.data());
+		const __mmask8 all = 0xFF;
+		const __m512i zero = _mm512_setzero_si512();
+		const __m512i one = _mm512_set1_epi64(1);
+		const __m512i byte = _mm512_set1_epi64(0xFF);
+		const __m512i none = _mm512_set1_epi64(0xFFFF);
+
+		__m512i rng = _mm512_loadu_si512(&random[board]);
+		rng = _mm512_xor_si512(rng, _mm512_maskz_slli_epi64(all, rng, 13));
+		rng = _mm512_xor_si512(rng, _mm512_maskz_srli_epi64(all, rng, 7));
+		rng = _mm512_xor_si512(rng, _mm512_maskz_slli_epi64(all, rng, 17));
+		_mm512_storeu_si512(&random[board], rng);
+
+		__m512i seen = _mm512_loadu_si512(&visited[board]);
+		__m512i from = _mm512_loadu_si512(&current[board]);
+		__m512i candidates = _mm512_maskz_andnot_epi64(all, seen, _mm512_mask_i64gather_epi64(zero, all, from, table, 8));
+
+		__m512i best = none;
+		__m512i next = from;
+		for(int d = 0; d < 8; ++d) {
+			__m512i target = _mm512_add_epi64(from, _mm512_set1_epi64(offsets[d]));
+			__m512i bit = _mm512_maskz_sllv_epi64(all, one, target);	// Zero when target is off the bitboard.
+			__mmask8 valid = _mm512_test_epi64_mask(candidates, bit);
+
+			__m512i score = _mm512_and_si512(_mm512_maskz_srli_epi64(all, rng, 8 * d), byte);
+			if(policy == BatchPolicy::Warnsdorff) {
+				__m512i attacks = _mm512_mask_i64gather_epi64(zero, valid, target, table, 8);
+				__m512i onward = _mm512_maskz_popcnt_epi64(all, _mm512_maskz_andnot_epi64(all, seen, attacks));
+				score = _mm512_or_si512(score, _mm512_maskz_slli_epi64(all, onward, 8));
+			}
+
+			__mmask8 better = _mm512_mask_cmplt_epu64_mask(valid, score, best);
+			best = _mm512_mask_mov_epi64(best, better, score);
+			next = _mm512_mask_mov_epi64(next, better, target);
+		}
+
+		__mmask8 moved = _mm512_cmplt_epu64_mask(best, none);
+		__m512i bit = _mm512_maskz_sllv_epi64(moved, one, next);
+		_mm512_storeu_si512(&current[board], next);
+		_mm512_storeu_si512(&visited[board], _mm512_or_si512(seen, bit));
+		__m512i lengths = _mm512_loadu_si512(&length[board]);
+		_mm512_storeu_si512(&length[board], _mm512_mask_add_epi64(lengths, moved, lengths, one));
+
+		return static_cast<uint32_t>(static_cast<uint8_t>(~moved));
+	}
+#endif
+
+	BatchPolicy policy;
+	std::vector<int> starts;
+	int boardCount;
+	int offsets[8];
+
+	// One entry per board.
+	std::vector<Bitboard> visited;
+	std::vector<uint64_t> current;
+	std::vector<uint64_t> length;
+	std::vector<uint64_t> random;
+	std::vector<int> start;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// One bit per tile. Bit n is the tile with index n, where index = columns * row + column
+// (row 0 is rank 1, column 0 is file A), the same layout KnightsTour uses for the chessboard.
+using Bitboard = uint64_t;
+
+inline constexpr Bitboard square_bit(int index) {
+	return Bitboard(1) << index;
+}
+
+inline int popcount(Bitboard board) {
+#if defined(_MSC_VER)
+	return static_cast<int>(__popcnt64(board));
+#else
+	return __builtin_popcountll(board);
+#endif
+}
+
+// Index of the lowest set bit. board must not be empty.
+inline int lowest_square(Bitboard board) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, board);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(board);
+#endif
+}
+
+// Clears the lowest set bit and returns its index. board must not be empty.
+inline int pop_lowest_square(Bitboard& board) {
+	int index = lowest_square(board);
+	board &= board - 1;
+	return index;
+}
+
+// Precomputed knight moves for every tile of a Rows x Columns board.
+// table[index] has a bit set for each tile a knight standing on index can jump to.
+template <int Rows, int Columns>
+struct KnightAttacks {
+	static_assert(Rows > 0 && Columns > 0 && Rows * Columns <= 64, "Board must fit in a 64 bit bitboard.");
+
+	static constexpr int tileCount = Rows * Columns;
+
+	static constexpr std::array<Bitboard, tileCount> build() {
+		constexpr int rowOffsets[8]    = { -2, -2, -1, -1, 1, 1, 2, 2 };
+		constexpr int columnOffsets[8] = { -1, 1, -2, 2, -2, 2, -1, 1 };
+
+		std::array<Bitboard, tileCount> result {};
+		for(int index = 0; index < tileCount; ++index) {
+			int row = index / Columns;
+			int column = index % Columns;
+			Bitboard attacks = 0;
+			for(int i = 0; i < 8; ++i) {
+				int targetRow = row + rowOffsets[i];
+				int targetColumn = column + columnOffsets[i];
+				if(targetRow >= 0 && targetRow < Rows && targetColumn >= 0 && targetColumn < Columns)
+					attacks |= square_bit(Columns * targetRow + targetColumn);
+			}
+			result[index] = attacks;
+		}
+		return result;
+	}
+
+	static constexpr std::array<Bitboard, tileCount> table = build();
+
+	// Mask with a bit set for every tile on the board.
+	static constexpr Bitboard allTiles = tileCount == 64 ? ~Bitboard(0) : (square_bit(tileCount) - 1);
+
+	// Tiles reachable from index that have not been visited yet.
+	static Bitboard visitable(int index, Bitboard visited) {
+		return table[index] & ~visited;
+	}
+
+	// Number of onward moves from index given the visited set (Warnsdorff degree).
+	static int degree(int index, Bitboard visited) {
+		return popcount(table[index] & ~visited);
+	}
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// The eight knight jumps as (row, column) offsets.
+constexpr int knightRowOffsets[8]    = { -2, -2, -1, -1, 1, 1, 2, 2 };
+constexpr int knightColumnOffsets[8] = { -1, 1, -2, 2, -2, 2, -1, 1 };
+
+// Board with dimensions known at compile time. Tiles are numbered columns * row + column.
+// The move lists for every tile are built at compile time, so walking the moves of a tile is
+// a fixed length loop over a constant table that the compiler can unroll.
+template <int Rows, int Columns>
+struct Board {
+	static_assert(Rows > 0 && Columns > 0 && Rows * Columns <= 65536, "Board must have between 1 and 65536 tiles.");
+
+	static constexpr int rowCount = Rows;
+	static constexpr int columnCount = Columns;
+	static constexpr int tileCount = Rows * Columns;
+	using TileIndex = std::conditional_t<(tileCount <= 256), uint8_t, uint16_t>;
+
+	struct MoveList {
+		uint8_t count;
+		TileIndex targets[8];
+	};
+
+	static constexpr std::array<MoveList, tileCount> build() {
+		std::array<MoveList, tileCount> result {};
+		for(int index = 0; index < tileCount; ++index) {
+			int row = index / Columns;
+			int column = index % Columns;
+			MoveList moves {};
+			for(int i = 0; i < 8; ++i) {
+				int targetRow = row + knightRowOffsets[i];
+				int targetColumn = column + knightColumnOffsets[i];
+				if(targetRow >= 0 && targetRow < Rows && targetColumn >= 0 && targetColumn < Columns)
+					moves.targets[moves.count++] = static_cast<TileIndex>(Columns * targetRow + targetColumn);
+			}
+			result[index] = moves;
+		}
+		return result;
+	}
+
+	static constexpr std::array<MoveList, tileCount> moves = build();
+
+	static constexpr int rows() { return Rows; }
+	static constexpr int columns() { return Columns; }
+	static constexpr int tile_count() { return tileCount; }
+	static constexpr int index(int row, int column) { return Columns * row + column; }
+	static constexpr int row(int index) { return index / Columns; }
+	static constexpr int column(int index) { return index % Columns; }
+	static constexpr int move_count(int index) { return moves[index].count; }
+
+	// Calls f(target) for every tile a knight on index can jump to.
+	template <typename Function>
+	static void for_each_move(int index, Function&& f) {
+		const MoveList& list = moves[index];
+		for(int i = 0; i < list.count; ++i)
+			f(static_cast<int>(list.targets[i]));
+	}
+};
+
+// Board with dimensions chosen at run time, up to maxDimension on each side.
+// Instead of a neighbour list per tile it keeps one byte per tile saying which of the eight
+// jumps stay on the board, plus the eight index offsets, so a 1000x1000 board costs 1 MB.
+class DynamicBoard {
+public:
+	static constexpr int maxDimension = 1000;
+
+	DynamicBoard(int rows, int columns) : rowCount(rows), columnCount(columns) {
+		if(rows < 1 || columns < 1 || rows > maxDimension || columns > maxDimension)
+			throw std::invalid_argument("Board dimensions must be between 1 and " + std::to_string(maxDimension) + ".");
+
+		for(int i = 0; i < 8; ++i)
+			offsets[i] = knightRowOffsets[i] * columns + knightColumnOffsets[i];
+
+		moveMasks.resize(static_cast<size_t>(rows) * columns);
+		for(int row = 0; row < rows; ++row) {
+			for(int column = 0; column < columns; ++column) {
+				uint8_t mask = 0;
+				for(int i = 0; i < 8; ++i) {
+					int targetRow = row + knightRowOffsets[i];
+					int targetColumn = column + knightColumnOffsets[i];
+					if(targetRow >= 0 && targetRow < rows && targetColumn >= 0 && targetColumn < columns)
+						mask |= static_cast<uint8_t>(1u << i);
+				}
+				moveMasks[static_cast<size_t>(row) * columns + column] = mask;
+			}
+		}
+	}
+
+	int rows() const { return rowCount; }
+	int columns() const { return columnCount; }
+	int tile_count() const { return rowCount * columnCount; }
+	int index(int row, int column) const { return columnCount * row + column; }
+	int row(int index) const { return index / columnCount; }
+	int column(int index) const { return index % columnCount; }
+
+	int move_count(int index) const {
+		uint8_t mask = moveMasks[index];
+		int count = 0;
+		for(; mask; mask &= mask - 1)
+			++count;
+		return count;
+	}
+
+	// Calls f(target) for every tile a knight on index can jump to.
+	template <typename Function>
+	void for_each_move(int index, Function&& f) const {
+		uint8_t mask = moveMasks[index];
+		for(int i = 0; mask; ++i, mask >>= 1) {
+			if(mask & 1)
+				f(index + offsets[i]);
+		}
+	}
+
+private:
+	int rowCount;
+	int columnCount;
+	int offsets[8];
+	std::vector<uint8_t> moveMasks;
+};
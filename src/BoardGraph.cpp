@@ -0,0 +1,116 @@
+#include "BoardGraph.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+void check_size(int rows, int columns) {
+	if(rows < 1 || columns < 1 || rows > BoardGraph::maxDimension || columns > BoardGraph::maxDimension)
+		throw std::invalid_argument("Board dimensions must be between 1 and " + std::to_string(BoardGraph::maxDimension) + ".");
+}
+
+}
+
+BoardShape BoardShape::rectangle(int rows, int columns, BoardTopology topology) {
+	check_size(rows, columns);
+	BoardShape shape;
+	shape.rows = rows;
+	shape.columns = columns;
+	shape.topology = topology;
+	shape.blocked.assign(static_cast<size_t>(rows) * columns, 0);
+	return shape;
+}
+
+BoardShape BoardShape::l_shape(int rows, int columns, int cutRows, int cutColumns) {
+	if(cutRows < 0 || cutColumns < 0 || cutRows >= rows || cutColumns >= columns)
+		throw std::invalid_argument("The cut corner must be smaller than the board.");
+
+	BoardShape shape = rectangle(rows, columns);
+	for(int row = rows - cutRows; row < rows; ++row) {
+		for(int column = columns - cutColumns; column < columns; ++column)
+			shape.block(columns * row + column);
+	}
+	return shape;
+}
+
+BoardShape BoardShape::from_text(const std::string& text, BoardTopology topology) {
+	std::vector<std::string> lines;
+	size_t begin = 0;
+	while(begin < text.size()) {
+		size_t end = text.find('\n', begin);
+		if(end == std::string::npos)
+			end = text.size();
+		std::string line = text.substr(begin, end - begin);
+		if(line.empty() == false && line.back() == '\r')
+			line.pop_back();
+		if(line.empty() == false)
+			lines.push_back(line);
+		begin = end + 1;
+	}
+
+	if(lines.empty())
+		throw std::invalid_argument("A board needs at least one row.");
+	for(const std::string& line : lines) {
+		if(line.size() != lines[0].size())
+			throw std::invalid_argument("Every row of a board must have the same length.");
+	}
+
+	const int rows = static_cast<int>(std::min<size_t>(lines.size(), BoardGraph::maxDimension + 1));
+	const int columns = static_cast<int>(std::min<size_t>(lines[0].size(), BoardGraph::maxDimension + 1));
+	BoardShape shape = rectangle(rows, columns, topology);
+	for(int row = 0; row < rows; ++row) {
+		const std::string& line = lines[rows - 1 - row];
+		for(int column = 0; column < columns; ++column) {
+			if(line[column] == '#')
+				shape.block(columns * row + column);
+		}
+	}
+	return shape;
+}
+
+BoardGraph::BoardGraph(int rows, int columns, BoardTopology topology)
+	: rowCount(rows), columnCount(columns), boardTopology(topology), openCount(rows * columns) {
+	check_size(rows, columns);
+	offsets.assign(static_cast<size_t>(tile_count()) + 1, 0);
+	open.assign(static_cast<size_t>(tile_count()), 1);
+}
+
+BoardGraph::BoardGraph(const BoardShape& shape) : BoardGraph(shape.rows, shape.columns, shape.topology) {
+	if(shape.blocked.empty() == false && shape.blocked.size() != open.size())
+		throw std::invalid_argument("The blocked tiles do not match the board size.");
+
+	const bool wrapColumns = shape.topology != BoardTopology::Flat;
+	const bool wrapRows = shape.topology == BoardTopology::Torus;
+	for(int tile = 0; tile < tile_count(); ++tile) {
+		if(shape.is_blocked(tile)) {
+			open[tile] = 0;
+			--openCount;
+		}
+	}
+
+	targets.reserve(static_cast<size_t>(tile_count()) * 8);
+	for(int tile = 0; tile < tile_count(); ++tile) {
+		const size_t first = targets.size();
+		if(open[tile]) {
+			for(int i = 0; i < 8; ++i) {
+				int targetRow = row(tile) + knightRowOffsets[i];
+				int targetColumn = column(tile) + knightColumnOffsets[i];
+				if(wrapRows)
+					targetRow = (targetRow % rowCount + rowCount) % rowCount;
+				if(wrapColumns)
+					targetColumn = (targetColumn % columnCount + columnCount) % columnCount;
+				if(targetRow < 0 || targetRow >= rowCount || targetColumn < 0 || targetColumn >= columnCount)
+					continue;
+
+				// On narrow wrapped boards two jumps can land on the same tile, or on the start.
+				uint32_t target = static_cast<uint32_t>(index(targetRow, targetColumn));
+				if(open[target] && static_cast<int>(target) != tile &&
+					std::find(targets.begin() + first, targets.end(), target) == targets.end())
+					targets.push_back(target);
+			}
+		}
+		offsets[tile + 1] = static_cast<uint32_t>(targets.size());
+	}
+	targets.shrink_to_fit();
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+
+// How the edges of a board connect.
+enum class BoardTopology {
+	Flat,		// Jumps over an edge leave the board.
+	Cylinder,	// The left and right edges are joined, so columns wrap around.
+	Torus		// Columns and rows both wrap around.
+};
+
+// Size, topology and blocked tiles of a board, before it is compiled into a BoardGraph.
+struct BoardShape {
+	int rows = 8;
+	int columns = 8;
+	BoardTopology topology = BoardTopology::Flat;
+	std::vector<uint8_t> blocked;	// One per tile, non-zero for tiles the knight may not enter. Empty if none are.
+
+	static BoardShape rectangle(int rows, int columns, BoardTopology topology = BoardTopology::Flat);
+
+	// rows x columns with the top right cutRows x cutColumns corner blocked.
+	static BoardShape l_shape(int rows, int columns, int cutRows, int cutColumns);
+
+	// One line per row, top row first like print_chessboard, '#' for a blocked tile and any
+	// other character for an open one. Every line must have the same length.
+	static BoardShape from_text(const std::string& text, BoardTopology topology = BoardTopology::Flat);
+
+	void block(int tile) {
+		blocked.resize(static_cast<size_t>(rows) * columns, 0);
+		blocked[tile] = 1;
+	}
+	bool is_blocked(int tile) const { return blocked.empty() == false && blocked[tile] != 0; }
+};
+
+// A board shape compiled into its knight's move graph, in compressed sparse row form: the
+// moves of tile i are targets[offsets[i]] up to targets[offsets[i + 1]]. Wrapped edges and
+// blocked tiles are resolved once here, so walking the moves of a tile is a loop over a short
+// array with no bounds checks.
+//
+// Has the same interface as the board types in Board.h, so warnsdorff_tour and sat_tour run
+// on any shape. Blocked tiles keep their index but have no moves and are no move's target.
+class BoardGraph {
+public:
+	static constexpr int maxDimension = 1000;
+
+	explicit BoardGraph(const BoardShape& shape);
+
+	// The graph of a board type from Board.h.
+	template <typename BoardType>
+	static BoardGraph from_board(const BoardType& board) {
+		BoardGraph graph(board.rows(), board.columns(), BoardTopology::Flat);
+		for(int tile = 0; tile < board.tile_count(); ++tile) {
+			board.for_each_move(tile, [&](int target) { graph.targets.push_back(static_cast<uint32_t>(target)); });
+			graph.offsets[tile + 1] = static_cast<uint32_t>(graph.targets.size());
+		}
+		return graph;
+	}
+
+	int rows() const { return rowCount; }
+	int columns() const { return columnCount; }
+	int tile_count() const { return rowCount * columnCount; }
+	int index(int row, int column) const { return columnCount * row + column; }
+	int row(int index) const { return index / columnCount; }
+	int column(int index) const { return index % columnCount; }
+	BoardTopology topology() const { return boardTopology; }
+
+	bool is_open(int index) const { return open[index] != 0; }
+	int open_tile_count() const { return openCount; }
+
+	int move_count(int index) const { return static_cast<int>(offsets[index + 1] - offsets[index]); }
+	const uint32_t* moves_begin(int index) const { return targets.data() + offsets[index]; }
+	const uint32_t* moves_end(int index) const { return targets.data() + offsets[index + 1]; }
+
+	// Calls f(target) for every tile a knight on index can jump to.
+	template <typename Function>
+	void for_each_move(int index, Function&& f) const {
+		for(const uint32_t* target = moves_begin(index); target != moves_end(index); ++target)
+			f(static_cast<int>(*target));
+	}
+
+	size_t memory_bytes() const { return offsets.size() * sizeof(uint32_t) + targets.size() * sizeof(uint32_t) + open.size(); }
+
+private:
+	BoardGraph(int rows, int columns, BoardTopology topology);
+
+	int rowCount;
+	int columnCount;
+	BoardTopology boardTopology;
+	int openCount;
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> targets;
+	std::vector<uint8_t> open;
+};
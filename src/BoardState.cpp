@@ -0,0 +1,153 @@
+#include "BoardState.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+const std::shared_ptr<const BoardGraph>& rectangle_graph() {
+	static const std::shared_ptr<const BoardGraph> graph = std::make_shared<const BoardGraph>(BoardShape::rectangle(rows, columns));
+	return graph;
+}
+
+}
+
+BoardState::BoardState() : BoardState(rectangle_graph()) {}
+
+BoardState::BoardState(const BoardGraph& graph) : BoardState(std::make_shared<const BoardGraph>(graph)) {}
+
+BoardState::BoardState(std::shared_ptr<const BoardGraph> sharedGraph) : boardGraph(std::move(sharedGraph)) {
+	if(boardGraph == nullptr)
+		throw std::invalid_argument("The board needs a move graph.");
+	const BoardGraph& graph = *boardGraph;
+	if(graph.rows() != rows || graph.columns() != columns)
+		throw std::invalid_argument("The board must have " + std::to_string(rows) + " rows and " + std::to_string(columns) + " columns.");
+
+	for(int i = 0; i < tile_count(); ++i) {
+		if(graph.is_open(i))
+			openTiles |= square_bit(i);
+		graph.for_each_move(i, [&](int target) { tileMoves[i] |= square_bit(target); });
+		onwardDegree[i] = static_cast<uint8_t>(graph.move_count(i));
+	}
+}
+
+bool BoardState::enforce_next_move(int index) const {
+	if(index < 0 || index >= tile_count())
+		return false;
+
+	if(is_first_move_made() == false)
+		return is_open(index);
+
+	return is_visitable(index);
+}
+
+bool BoardState::make_move(int index) {
+	if(enforce_next_move(index) == false)
+		return false;
+
+	currentNode = moveTree.add(currentNode, index);
+	visit(index);
+	calculate_visitable_tile();
+	return true;
+}
+
+void BoardState::undo_move() {
+	if(current_move() > 0) {
+		unvisit(current_tile());
+		currentNode = moveTree.parent(currentNode);
+		calculate_visitable_tile();
+	}
+}
+
+void BoardState::redo_move() {
+	MoveTree::NodeId next = moveTree.redo_child(currentNode);
+	if(next != MoveTree::none) {
+		currentNode = next;
+		visit(current_tile());
+		calculate_visitable_tile();
+	}
+}
+
+bool BoardState::jump_to(MoveTree::NodeId node) {
+	if(node == MoveTree::root || node >= moveTree.size())
+		return false;
+
+	// Undo up to the common ancestor, remembering the way down to node.
+	MoveTree::NodeId from = currentNode;
+	MoveTree::NodeId to = node;
+	std::array<MoveTree::NodeId, rows * columns> path;
+	int length = 0;
+	while(moveTree.depth(from) > moveTree.depth(to)) {
+		unvisit(moveTree.square(from));
+		from = moveTree.parent(from);
+	}
+	while(moveTree.depth(to) > moveTree.depth(from)) {
+		path[length++] = to;
+		to = moveTree.parent(to);
+	}
+	while(from != to) {
+		unvisit(moveTree.square(from));
+		from = moveTree.parent(from);
+		path[length++] = to;
+		to = moveTree.parent(to);
+	}
+
+	// Replay down to node, making it the line redo follows.
+	currentNode = from;
+	while(length > 0) {
+		currentNode = path[--length];
+		moveTree.promote(currentNode);
+		visit(current_tile());
+	}
+	calculate_visitable_tile();
+	return true;
+}
+
+std::vector<int> BoardState::moves_made() const {
+	std::vector<int> moves(moveTree.depth(currentNode));
+	for(MoveTree::NodeId node = currentNode; node != MoveTree::root; node = moveTree.parent(node))
+		moves[moveTree.depth(node) - 1] = moveTree.square(node);
+	for(MoveTree::NodeId node = moveTree.redo_child(currentNode); node != MoveTree::none; node = moveTree.redo_child(node))
+		moves.push_back(moveTree.square(node));
+	return moves;
+}
+
+int BoardState::first_tile() const {
+	MoveTree::NodeId node = currentNode;
+	while(node != MoveTree::root && moveTree.parent(node) != MoveTree::root)
+		node = moveTree.parent(node);
+	return node != MoveTree::root ? moveTree.square(node) : -1;
+}
+
+// Keeps the shape tables, which only depend on the graph.
+void BoardState::clear() {
+	moveTree = MoveTree();
+	currentNode = MoveTree::root;
+	visitableTileExists = true;
+	visitedTiles = 0;
+	visitableTiles = 0;
+	moveNumbers.fill(0);
+	for(int i = 0; i < tile_count(); ++i)
+		onwardDegree[i] = static_cast<uint8_t>(boardGraph->move_count(i));
+}
+
+void BoardState::visit(int index) {
+	moveNumbers[index] = static_cast<uint16_t>(moveTree.depth(currentNode));
+	visitedTiles |= square_bit(index);
+	for(Bitboard neighbours = tileMoves[index]; neighbours; )
+		--onwardDegree[pop_lowest_square(neighbours)];
+}
+
+// Exact reverse of visit, apart from the move number, which stays until the tile is visited again.
+void BoardState::unvisit(int index) {
+	visitedTiles &= ~square_bit(index);
+	for(Bitboard neighbours = tileMoves[index]; neighbours; )
+		++onwardDegree[pop_lowest_square(neighbours)];
+}
+
+void BoardState::calculate_visitable_tile() {
+	// Calculate which tiles can be visited based on the current tile knight is standing on.
+	visitableTiles = tileMoves[current_tile()] & ~visitedTiles;
+	visitableTileExists = visitableTiles != 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Bitboard.h"
+#include "BoardGraph.h"
+#include "MoveTree.h"
+
+constexpr uint8_t rows = 8;     // Total number of rows on a chess board.
+constexpr uint8_t columns = 8;  // Total number of columns on a chess board.
+
+// State of a single game: the chessboard, every line of moves explored so far and the
+// position in it.
+// Value type: copies share the immutable move graph and copy only the game state, so any
+// number of boards can be copied around cheaply and played on independently, including from
+// different threads.
+//
+// Moves, undos and redos only touch the knight neighbourhood of the tile that changed and
+// never scan the whole board.
+//
+// The board can have any shape that fits the rows x columns grid, with blocked tiles and
+// wrapped edges. Its move graph is turned into one bitboard of targets per tile up front.
+class BoardState {
+public:
+	BoardState();	// The plain rows x columns board, whose graph every such board shares.
+	explicit BoardState(std::shared_ptr<const BoardGraph> graph);	// Throws std::invalid_argument unless graph is rows x columns.
+	explicit BoardState(const BoardGraph& graph);	// Shares a copy of graph.
+
+	// Moves the knight to index if that is a legal move. Undone moves are kept as another
+	// variation in history(). Returns false and leaves the board untouched otherwise.
+	bool make_move(int index);
+	void undo_move();
+	void redo_move();	// Follows the variation last played from the current position.
+	void clear();	// Takes back every move, keeping the board shape.
+
+	// Sets the board to any position in history() other than the root. Only the moves between
+	// the two positions are undone and replayed, however long the history is.
+	bool jump_to(MoveTree::NodeId node);
+
+	bool enforce_next_move(int index) const;
+
+	// Tiles are stored as parallel arrays: a bit per tile for visited and visitable, and the
+	// move number each tile was last visited on. Rendering data lives in SceneRenderer.
+	static constexpr int tile_count() { return rows * columns; }
+	const BoardGraph& graph() const { return *boardGraph; }
+	bool is_open(int index) const { return (openTiles & square_bit(index)) != 0; }	// False for blocked tiles.
+	bool is_visited(int index) const { return (visitedTiles & square_bit(index)) != 0; }
+	bool is_visitable(int index) const { return (visitableTiles & square_bit(index)) != 0; }
+	int visited_on_move(int index) const { return moveNumbers[index]; }	// 1 for the first move, 0 if never visited.
+	const MoveTree& history() const { return moveTree; }
+	MoveTree::NodeId cursor() const { return currentNode; }
+	std::vector<int> moves_made() const;	// The current line, including moves redo would replay.
+	int current_move() const { return moveTree.depth(currentNode) - 1; }	// Index into moves_made(), -1 before the first move.
+	int current_tile() const { return currentNode != MoveTree::root ? moveTree.square(currentNode) : -1; }
+	int first_tile() const;
+	bool is_first_move_made() const { return currentNode != MoveTree::root; }
+	bool visitable_tile_exists() const { return visitableTileExists; }
+	Bitboard visited_tiles() const { return visitedTiles; }
+	Bitboard visitable_tiles() const { return visitableTiles; }
+	int onward_degree(int index) const { return onwardDegree[index]; }	// Unvisited tiles a knight's move from index.
+
+private:
+	void visit(int index);
+	void unvisit(int index);
+	void calculate_visitable_tile();
+
+	std::shared_ptr<const BoardGraph> boardGraph;
+	std::array<Bitboard, rows * columns> tileMoves{};	// Bit per tile a knight can jump to from each tile.
+	Bitboard openTiles = 0;
+	MoveTree moveTree{};
+	MoveTree::NodeId currentNode = MoveTree::root;
+	bool visitableTileExists = true;
+	Bitboard visitedTiles = 0;		// Bit per tile, set when the knight has been there.
+	Bitboard visitableTiles = 0;	// Bit per tile the knight can jump to next.
+	std::array<uint16_t, rows * columns> moveNumbers{};
+	std::array<uint8_t, rows * columns> onwardDegree{};
+};
@@ -10,6 +10,38 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, unsigned int msg, WPARAM wParam, LPARAM
 	return DXApp::GetApp()->MsgProc(hwnd, msg, wParam, lParam);
 }
 
+D3D12FrameQueue::D3D12FrameQueue(ID3D12CommandQueue* queue, ID3D12Fence* fence)
+	: mQueue(queue), mFence(fence)
+{
+	mFenceEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+	if (mFenceEvent == nullptr)
+		ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+}
+
+D3D12FrameQueue::~D3D12FrameQueue()
+{
+	CloseHandle(mFenceEvent);
+}
+
+void D3D12FrameQueue::signal(uint64_t value)
+{
+	ThrowIfFailed(mQueue->Signal(mFence, value));
+}
+
+uint64_t D3D12FrameQueue::completed_value() const
+{
+	return mFence->GetCompletedValue();
+}
+
+void D3D12FrameQueue::wait_for(uint64_t value)
+{
+	if (mFence->GetCompletedValue() >= value)
+		return;
+
+	ThrowIfFailed(mFence->SetEventOnCompletion(value, mFenceEvent));
+	WaitForSingleObject(mFenceEvent, INFINITE);
+}
+
 DXApp* DXApp::mApp = nullptr;
 DXApp* DXApp::GetApp()
 {
@@ -27,6 +59,8 @@ DXApp::~DXApp()
 {
 	if (mDevice != nullptr)
 		FlushCommandQueue();
+	if (mFrameLatencyWaitable != nullptr)
+		CloseHandle(mFrameLatencyWaitable);
 }
 
 HINSTANCE DXApp::AppInst() const
@@ -55,7 +89,6 @@ int DXApp::Run()
 			mTimer.Tick();
 
 			if (!mAppPaused) {
-				FlushCommandQueue();
 				CalculateFrameStats();
 				OnUpdate(mTimer);
 				Draw(mTimer);
@@ -79,15 +112,6 @@ bool DXApp::Initialize()
 
 	OnResize();
 
-	{
-		ThrowIfFailed(mDevice->CreateFence(mFenceValues[mFrameIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
-		mFenceValues[mFrameIndex]++;
-
-		mFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-		if (mFenceEvent == nullptr)
-			ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));		
-	}
-
 	return true;
 }
 
@@ -223,8 +247,10 @@ void DXApp::OnResize()
 	assert(mSwapChain);
 	assert(mDirectCmdListAlloc);
 
-	// flush before changing any resources
+	// flush before changing any resources, then reuse the allocator's memory now the gpu is
+	// done with it. ApplyPresentChange comes through here as well.
 	FlushCommandQueue();
+	ThrowIfFailed(mDirectCmdListAlloc->Reset());
 	ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
 
 	// release the previous resources we will be recreating.
@@ -237,7 +263,7 @@ void DXApp::OnResize()
 		mWidth,
 		mHeight,
 		mBackBufferFormat,
-		DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
+		SwapChainFlags()));
 
 	mCurrBackBuffer = 0;
 
@@ -356,6 +382,7 @@ bool DXApp::InitDirect3D()
 #endif
 
 	ThrowIfFailed(CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&mdxgiFactory)));
+	mPresent = PresentController(CheckTearingSupport(), mPresent.requested_mode(), mPresent.max_latency());
 
 	HRESULT hardwareResult = D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(&mDevice));
 
@@ -377,6 +404,8 @@ bool DXApp::InitDirect3D()
 #endif
 
 	CreateCommandObjects();
+	mFrameQueue = std::make_unique<D3D12FrameQueue>(mCommandQueue.Get(), mFence.Get());
+	mFrames = std::make_unique<FramePipeline>(*mFrameQueue, FrameResourceCount);
 	CreateSwapChain();
 	CreateRtvAndDsvDescriptorHeaps();
 
@@ -417,6 +446,7 @@ void DXApp::CreateSwapChain()
 	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 	swapChainDesc.Scaling = DXGI_SCALING_STRETCH;
 	swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+	swapChainDesc.Flags = SwapChainFlags();
 
 	ComPtr<IDXGISwapChain1> swapChain1;
 	ThrowIfFailed(mdxgiFactory->CreateSwapChainForHwnd(
@@ -428,22 +458,75 @@ void DXApp::CreateSwapChain()
 		&swapChain1)
 	);
 	ThrowIfFailed(swapChain1.As(&mSwapChain));
+
+	if (mFrameLatencyWaitable != nullptr) {
+		CloseHandle(mFrameLatencyWaitable);
+		mFrameLatencyWaitable = nullptr;
+	}
+	if (mPresent.waitable()) {
+		ThrowIfFailed(mSwapChain->SetMaximumFrameLatency(mPresent.max_latency()));
+		mFrameLatencyWaitable = mSwapChain->GetFrameLatencyWaitableObject();
+	}
 }
 
-void DXApp::FlushCommandQueue()
+bool DXApp::CheckTearingSupport() const
 {
-	mCurrentFence++;
+	BOOL allowTearing = FALSE;
+	if (FAILED(mdxgiFactory->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing))))
+		return false;
+	return allowTearing == TRUE;
+}
 
-	ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), mCurrentFence));
+// Resizing has to pass the flags the swap chain was created with.
+UINT DXApp::SwapChainFlags() const
+{
+	UINT flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+	if (mPresent.tearing_supported())
+		flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+	if (mPresent.waitable())
+		flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+	return flags;
+}
 
-	if (mFence->GetCompletedValue() < mCurrentFence) {
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
+void DXApp::ApplyPresentChange(SwapChainChange change)
+{
+	switch (change)
+	{
+	case SwapChainChange::SetLatency:
+		ThrowIfFailed(mSwapChain->SetMaximumFrameLatency(mPresent.max_latency()));
+		break;
+	case SwapChainChange::Recreate:
+		// the waitable flag can't be changed by ResizeBuffers, so start over with new buffers.
+		FlushCommandQueue();
+		for (int i = 0; i < SwapChainBufferCount; ++i)
+			mSwapChainBuffer[i].Reset();
+		CreateSwapChain();
+		OnResize();
+		break;
+	default:
+		break;
+	}
+}
 
-		ThrowIfFailed(mFence->SetEventOnCompletion(mCurrentFence, eventHandle));
+void DXApp::WaitForSwapChain()
+{
+	if (mFrameLatencyWaitable != nullptr)
+		WaitForSingleObjectEx(mFrameLatencyWaitable, 1000, TRUE);
+}
 
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+void DXApp::PresentFrame()
+{
+	UINT flags = mPresent.allow_tearing() ? DXGI_PRESENT_ALLOW_TEARING : 0;
+	ThrowIfFailed(mSwapChain->Present(mPresent.sync_interval(), flags));
+	mCurrBackBuffer = (mCurrBackBuffer + 1) % SwapChainBufferCount;
+}
+
+// Waits for every frame in flight. Only for resizing and shutdown, frames themselves go
+// through mFrames.
+void DXApp::FlushCommandQueue()
+{
+	if (mFrames)
+		mFrames->flush();
 }
 
 ID3D12Resource* DXApp::CurrentBackBuffer() const
@@ -481,7 +564,8 @@ void DXApp::CalculateFrameStats()
 
 		std::wstring windowText = mWindowCaption +
 			L"    fps: " + fpsStr +
-			L"   mspf: " + mspfStr;
+			L"   mspf: " + mspfStr +
+			CaptionStats();
 
 		SetWindowText(mhMainWnd, windowText.c_str());
 
@@ -6,8 +6,27 @@
 #endif
 
 #include "DXUtil.h"
+#include "FramePipeline.h"
+#include "PresentMode.h"
 #include "Timer.h"
 
+// FrameQueue on a D3D12 command queue and fence.
+class D3D12FrameQueue : public FrameQueue
+{
+public:
+	D3D12FrameQueue(ID3D12CommandQueue* queue, ID3D12Fence* fence);
+	~D3D12FrameQueue();
+
+	void signal(uint64_t value) override;
+	uint64_t completed_value() const override;
+	void wait_for(uint64_t value) override;
+
+private:
+	ID3D12CommandQueue* mQueue;
+	ID3D12Fence* mFence;
+	HANDLE mFenceEvent;
+};
+
 class DXApp
 {
 protected:
@@ -41,11 +60,21 @@ protected:
 	// keyboard inputs
 	virtual void OnKeyUp(WPARAM button) = 0;
 
+	// appended to the frame stats in the window caption
+	virtual std::wstring CaptionStats() const { return std::wstring(); }
+
 	bool InitMainWindow();
 	bool InitDirect3D();
 	void CreateCommandObjects();
 	void CreateSwapChain();
 
+	// present modes
+	bool CheckTearingSupport() const;
+	UINT SwapChainFlags() const;
+	void ApplyPresentChange(SwapChainChange change);
+	void WaitForSwapChain();	// blocks in waitable mode until the swap chain takes another frame
+	void PresentFrame();
+
 	void FlushCommandQueue();
 
 	ID3D12Resource* CurrentBackBuffer() const;
@@ -80,10 +109,14 @@ protected:
 	Microsoft::WRL::ComPtr<ID3D12Resource> mDepthStencilBuffer;
 
 	Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
-	UINT64 mCurrentFence = 0;
-	unsigned int mFrameIndex;
-	HANDLE mFenceEvent;
-	uint64_t mFenceValues[SwapChainBufferCount];
+
+	// frames the cpu may record ahead of the gpu, each with its own command allocator and upload space
+	static const int FrameResourceCount = 3;
+	std::unique_ptr<D3D12FrameQueue> mFrameQueue;
+	std::unique_ptr<FramePipeline> mFrames;
+
+	PresentController mPresent;
+	HANDLE mFrameLatencyWaitable = nullptr;
 
 	Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCommandQueue;
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> mDirectCmdListAlloc;
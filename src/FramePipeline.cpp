@@ -0,0 +1,32 @@
+#include "FramePipeline.h"
+
+#include <stdexcept>
+#include <string>
+
+FramePipeline::FramePipeline(FrameQueue& queue, int frameCount) : queue(queue) {
+	if(frameCount < 1 || frameCount > maxFrames)
+		throw std::invalid_argument("Frames in flight must be between 1 and " + std::to_string(maxFrames) + ".");
+	fenceValues.assign(frameCount, 0);
+}
+
+void FramePipeline::begin_frame() {
+	const uint64_t value = fenceValues[current];
+	if(value != 0 && queue.completed_value() < value) {
+		++stallCount;
+		queue.wait_for(value);
+	}
+}
+
+void FramePipeline::end_frame() {
+	fenceValues[current] = nextFence;
+	queue.signal(nextFence++);
+	++submitted;
+	current = (current + 1) % frame_count();
+}
+
+void FramePipeline::flush() {
+	const uint64_t value = nextFence++;
+	queue.signal(value);
+	if(queue.completed_value() < value)
+		queue.wait_for(value);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// The part of a GPU queue frame pipelining needs: a fence the queue sets once the work
+// submitted before the signal has run. Fence values only grow. The D3D12 renderer wraps its
+// command queue and fence in one, and anything without a GPU can fake it.
+class FrameQueue {
+public:
+	virtual ~FrameQueue() = default;
+
+	virtual void signal(uint64_t value) = 0;			// Sets the fence to value after the work submitted so far.
+	virtual uint64_t completed_value() const = 0;
+	virtual void wait_for(uint64_t value) = 0;			// Blocks until completed_value() reaches value.
+};
+
+// Lets the CPU record frame n while the GPU still runs the frames before it. Every frame in
+// flight has its own slot of resources, like a command allocator and a segment of an upload
+// ring, and the fence value signalled when its commands were submitted. A slot is reused only
+// once the GPU has passed that value, so the CPU waits only when it is a whole ring of frames
+// ahead, instead of flushing the queue after every frame.
+//
+//     pipeline.begin_frame();			// waits until the slot is free
+//     reset allocator[pipeline.frame_index()], write ring segment, record, submit
+//     pipeline.end_frame();			// signals the slot's fence, moves to the next slot
+class FramePipeline {
+public:
+	static constexpr int maxFrames = 8;
+
+	FramePipeline(FrameQueue& queue, int frameCount);	// Throws std::invalid_argument unless 1 <= frameCount <= maxFrames.
+
+	int frame_count() const { return static_cast<int>(fenceValues.size()); }
+	int frame_index() const { return current; }		// The slot the CPU records into.
+
+	void begin_frame();
+	void end_frame();
+	void flush();	// Waits for everything submitted, e.g. before resizing buffers the GPU may still read.
+
+	// Fence value the GPU has to reach before slot can be reused, 0 if it never was submitted.
+	uint64_t fence_value(int slot) const { return fenceValues[slot]; }
+	uint64_t frames_submitted() const { return submitted; }
+	uint64_t stalls() const { return stallCount; }	// begin_frame calls that had to wait for the GPU.
+
+private:
+	FrameQueue& queue;
+	std::vector<uint64_t> fenceValues;
+	uint64_t nextFence = 1;
+	int current = 0;
+	uint64_t submitted = 0;
+	uint64_t stallCount = 0;
+};
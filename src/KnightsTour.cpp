@@ -1,212 +1,95 @@
 #include "KnightsTour.h"
 
-bool KnightsTour::is_valid_letter(char letter) {
-	return ((int)letter >= 65 && (int)letter <= 72) || ((int)letter >= 97 && (int)letter <= 104);
+namespace {
+
+// Clears board and plays the first length tiles of tour into its move history.
+template <typename Tile>
+void replay_tour(BoardState& board, const Tile* tour, int length) {
+	board.clear();
+	for(int i = 0; i < length; ++i)
+		board.make_move(static_cast<int>(tour[i]));
 }
 
-bool KnightsTour::is_valid_number(char number) {
-	return ((int)number >= 49 && (int)number <= 56);
 }
 
-int KnightsTour::chess_notation_to_index(std::string input) {
-	if(input.size() != 2) {
-		std::cout << "Invalid Input. Length should be 2.\n";
-		return -1;
-	}
-
-	char letter = static_cast<char>(input[0]);
-	bool isValidLetter = is_valid_letter(letter);        // is it uppercase or lowercase letter between A to H.
-	if(isValidLetter == false) {
-		std::cout << "Invalid letter input.\n";            // Throw if first character is not a letter.
-		return -1;
-	}
-
+bool KnightsTour::is_valid_letter(char letter, int boardColumns) {
 	// Convert lowercase letters to uppercase
 	if((int)letter >= 97 && (int)letter <= 122)
 		letter = (int)letter - 32;
 
-	char number = static_cast<char>(input[1]);
-	bool isValidNumber = is_valid_number(number);
-	if(isValidNumber == false) {
-		std::cout << "Invalid number input.\n";
-		return -1;
-	}
-
-	// Convert user input to tile index according to formula below.
-	// rows(8) * (number - 49) + (letter - 65) for upper letter
-	int index = rows * ((int)number - 49) + ((int)letter - 65);
-
-	return index;
+	return (int)letter >= 65 && (int)letter < 65 + std::min(boardColumns, 26);
 }
 
-std::string KnightsTour::index_to_chess_notation(int index) {
-	std::string result {};
-	int number = int(index / rows) + 49;
-	int letter = (index % columns) + 65;
-	result.push_back((char)letter);
-	result.push_back(((char)number));
-
-	return result;
+bool KnightsTour::is_valid_number(int number, int boardRows) {
+	return number >= 1 && number <= boardRows;
 }
 
-void KnightsTour::calculate_visitable_tile(const std::vector<int>::iterator& currentMove) {
-	// Reset previously calculated result first
-	for (auto& tile : chessboard) {
-		tile.isVisitable = false;
-		if(tile.isVisited)
-			tile.color = DirectX::XMFLOAT4(0.3f, 0.3f, 0.3f, 1.0f);
-		else
-			tile.color = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+int64_t KnightsTour::chess_notation_to_index(std::string input, int boardRows, int boardColumns) {
+	if(input.size() < 2 || input.size() > 16) {
+		std::cout << "Invalid Input. Length should be between 2 and 16.\n";
+		return -1;
 	}
 
-	std::string chessNotation = index_to_chess_notation(*currentMove);
-	int letter = chessNotation[0];
-	int number = chessNotation[1];
-
-	// Calculate which tiles can be visited based on the current tile knight is standing on.
-	visitableTileExists = false;
-	if(is_valid_letter(letter - 1) && is_valid_number(number - 2)) {
-		std::string tile {};
-		tile.push_back((char)(letter - 1));
-		tile.push_back((char)(number - 2));
-		int tileIndex = chess_notation_to_index(tile);
-		if(chessboard.at(tileIndex).isVisited == false) {
-			chessboard.at(tileIndex).isVisitable = true;
-			chessboard.at(tileIndex).color = DirectX::XMFLOAT4(0.3, 0.3, 0.7, 0.5);
-			visitableTileExists = true;
-		}
-	}
-	if(is_valid_letter(letter + 1) && is_valid_number(number - 2)) {
-		std::string tile {};
-		tile.push_back((char)(letter + 1));
-		tile.push_back((char)(number - 2));
-		int tileIndex = chess_notation_to_index(tile);
-		if (chessboard.at(tileIndex).isVisited == false) {
-			chessboard.at(tileIndex).isVisitable = true;
-			chessboard.at(tileIndex).color = DirectX::XMFLOAT4(0.3, 0.3, 0.7, 0.5);
-			visitableTileExists = true;
-		}
-	}
-	if(is_valid_letter(letter - 2) && is_valid_number(number - 1)) {
-		std::string tile {};
-		tile.push_back((char)(letter - 2));
-		tile.push_back((char)(number - 1));
-		int tileIndex = chess_notation_to_index(tile);
-		if (chessboard.at(tileIndex).isVisited == false) {
-			chessboard.at(tileIndex).isVisitable = true;
-			chessboard.at(tileIndex).color = DirectX::XMFLOAT4(0.3, 0.3, 0.7, 0.5);
-			visitableTileExists = true;
-		}
-	}
-	if(is_valid_letter(letter + 2) && is_valid_number(number - 1)) {
-		std::string tile {};
-		tile.push_back((char)(letter + 2));
-		tile.push_back((char)(number - 1));
-		int tileIndex = chess_notation_to_index(tile);
-		if (chessboard.at(tileIndex).isVisited == false) {
-			chessboard.at(tileIndex).isVisitable = true;
-			chessboard.at(tileIndex).color = DirectX::XMFLOAT4(0.3, 0.3, 0.7, 0.5);
-			visitableTileExists = true;
-		}
-	}
-	if(is_valid_letter(letter - 2) && is_valid_number(number + 1)) {
-		std::string tile {};
-		tile.push_back((char)(letter - 2));
-		tile.push_back((char)(number + 1));
-		int tileIndex = chess_notation_to_index(tile);
-		if (chessboard.at(tileIndex).isVisited == false) {
-			chessboard.at(tileIndex).isVisitable = true;
-			chessboard.at(tileIndex).color = DirectX::XMFLOAT4(0.3, 0.3, 0.7, 0.5);
-			visitableTileExists = true;
-		}
-	}
-	if(is_valid_letter(letter + 2) && is_valid_number(number + 1)) {
-		std::string tile {};
-		tile.push_back((char)(letter + 2));
-		tile.push_back((char)(number + 1));
-		int tileIndex = chess_notation_to_index(tile);
-		if (chessboard.at(tileIndex).isVisited == false) {
-			chessboard.at(tileIndex).isVisitable = true;
-			chessboard.at(tileIndex).color = DirectX::XMFLOAT4(0.3, 0.3, 0.7, 0.5);
-			visitableTileExists = true;
-		}
+	// Column letters go A-Z, then AA, AB and so on for boards wider than 26 columns.
+	size_t position = 0;
+	int64_t column = 0;
+	while(position < input.size() && is_valid_letter(input[position], boardColumns)) {
+		char letter = input[position];
+		// Convert lowercase letters to uppercase
+		if((int)letter >= 97 && (int)letter <= 122)
+			letter = (int)letter - 32;
+
+		column = column * 26 + ((int)letter - 64);
+		if(column > boardColumns)
+			break;
+		++position;
 	}
-	if(is_valid_letter(letter - 1) && is_valid_number(number + 2)) {
-		std::string tile {};
-		tile.push_back((char)(letter - 1));
-		tile.push_back((char)(number + 2));
-		int tileIndex = chess_notation_to_index(tile);
-		if (chessboard.at(tileIndex).isVisited == false) {
-			chessboard.at(tileIndex).isVisitable = true;
-			chessboard.at(tileIndex).color = DirectX::XMFLOAT4(0.3, 0.3, 0.7, 0.5);
-			visitableTileExists = true;
-		}
+
+	if(position == 0 || column > boardColumns || position == input.size()) {
+		std::cout << "Invalid letter input.\n";            // Throw if it does not start with a column.
+		return -1;
 	}
-	if(is_valid_letter(letter + 1) && is_valid_number(number + 2)) {
-		std::string tile {};
-		tile.push_back((char)(letter + 1));
-		tile.push_back((char)(number + 2));
-		int tileIndex = chess_notation_to_index(tile);
-		if (chessboard.at(tileIndex).isVisited == false) {
-			chessboard.at(tileIndex).isVisitable = true;
-			chessboard.at(tileIndex).color = DirectX::XMFLOAT4(0.3, 0.3, 0.7, 0.5);
-			visitableTileExists = true;
+
+	int64_t number = 0;
+	for(; position < input.size(); ++position) {
+		if((int)input[position] < 48 || (int)input[position] > 57 || number > boardRows) {
+			std::cout << "Invalid number input.\n";
+			return -1;
 		}
+		number = number * 10 + ((int)input[position] - 48);
 	}
-}
 
-bool KnightsTour::enforce_next_move(int index) {
-	if(isFirstMoveMade == false)
-		return true;
-
-	if(chessboard.at(index).isVisitable == false) {
-		std::cout << "You can't move there." << std::endl;
-		return false;
+	bool isValidNumber = number <= boardRows && is_valid_number(static_cast<int>(number), boardRows);
+	if(isValidNumber == false) {
+		std::cout << "Invalid number input.\n";
+		return -1;
 	}
-	else
-		return true;
-}
 
-void KnightsTour::make_move(const std::vector<int>::iterator& currentMove) {
-	isFirstMoveMade = true;
-	chessboard.at(*currentMove).set_visited(true);
-	chessboard.at(*currentMove).color = DirectX::XMFLOAT4(0.5, 1.0, 0.5, 0.);
+	// Convert user input to tile index according to formula below.
+	// columns * (number - 1) + (column - 1)
+	return boardColumns * (number - 1) + (column - 1);
 }
 
+std::string KnightsTour::index_to_chess_notation(int64_t index, int boardColumns) {
+	std::string result {};
 
-void KnightsTour::undo_move()
-{
-	if(currentMoveItr != movesMade.begin()) {
-		chessboard.at(*currentMoveItr).isVisited = false;
-		--currentMoveItr;
-		calculate_visitable_tile(currentMoveItr);
-		make_move(currentMoveItr);
+	// Column letters, least significant first, then reversed.
+	int64_t column = index % boardColumns + 1;
+	while(column > 0) {
+		--column;
+		result.push_back((char)(65 + column % 26));
+		column /= 26;
 	}
-}
+	std::reverse(result.begin(), result.end());
 
-void KnightsTour::redo_move()
-{
-	if(currentMoveItr != movesMade.end() - 1) {
-		chessboard.at(*currentMoveItr).isVisited = true;
-		++currentMoveItr;
-		calculate_visitable_tile(currentMoveItr);
-		make_move(currentMoveItr);
-	}
-}
-
-void KnightsTour::set_current_move_iterator(int index)
-{
-	// Remove any move made that comes after what currentMove iterator points to.
-	if (movesMade.empty() == false && currentMoveItr != movesMade.end() - 1)
-		movesMade.erase(currentMoveItr + 1, movesMade.end());
-	movesMade.push_back(index);
-	currentMoveItr = movesMade.end() - 1;
+	result += std::to_string(index / boardColumns + 1);
+	return result;
 }
 
-void KnightsTour::print_chessboard() {
+void KnightsTour::print_chessboard(const BoardState& board) {
 	// Print column letters (A-H)
 	std::cout << "  ";
-	for(int i = 65; i < 73; ++i)
+	for(int i = 65; i < 65 + columns; ++i)
 		std::cout << std::setw(4) << (char)i;
 
 	std::cout << std::endl << std::endl;
@@ -217,13 +100,16 @@ void KnightsTour::print_chessboard() {
 
 		// Print tiles
 		for(uint8_t column = 0; column < columns; ++column) {
-			if(chessboard.at((rows * row) + column).isVisited) {
-				if(chessboard.at((rows * row) + column).index == Tile::lastVisitedTileIndex)
+			int index = (columns * row) + column;
+			if(board.is_open(index) == false)
+				std::cout << std::setw(4) << " ";
+			else if(board.is_visited(index)) {
+				if(index == board.current_tile())
 					std::cout << std::setw(4) << "@";
 				else
-					std::cout << std::setw(4) << chessboard.at((rows * row) + column).visitedOnMoveNo;
+					std::cout << std::setw(4) << board.visited_on_move(index);
 			}
-			else if(chessboard.at((rows * row) + column).isVisitable)
+			else if(board.is_visitable(index))
 				std::cout << std::setw(4) << "o";
 			else
 				std::cout << std::setw(4) << "#";
@@ -232,14 +118,41 @@ void KnightsTour::print_chessboard() {
 	}
 }
 
-void KnightsTour::clear_screen() {
-	for (auto& tile : chessboard) {
-		tile.color = DirectX::XMFLOAT4(1.0, 1.0, 1.0, 1.0);
-		tile.isVisitable = false;
-		tile.isVisited = false;
-		tile.visitedTileCount = 0;
-		tile.lastVisitedTileIndex = -1;
+bool KnightsTour::solve_from(BoardState& board, int index, TieBreak tieBreak, uint64_t seed) {
+	if(index < 0 || index >= rows * columns)
+		return false;
+
+	if(board.is_open(index) == false)
+		return false;
+
+	// The plain board takes the bitboard solver, which never allocates. Other shapes walk the graph.
+	const BoardGraph& graph = board.graph();
+	if(graph.topology() == BoardTopology::Flat && graph.open_tile_count() == graph.tile_count()) {
+		Warnsdorff<rows, columns>::Tour tour{};
+		int length = Warnsdorff<rows, columns>(tieBreak, seed).solve(index, tour);
+		replay_tour(board, tour.data(), length);
+		return length == rows * columns;
 	}
-	KnightsTour::isFirstMoveMade = false;
-	KnightsTour::movesMade.clear();
+
+	std::vector<uint32_t> tour;
+	int length = warnsdorff_tour(graph, index, tour, tieBreak, seed);
+	replay_tour(board, tour.data(), length);
+	return length == graph.open_tile_count();
+}
+
+SatStatus KnightsTour::complete_tour(BoardState& board, TourType type, uint64_t maxConflicts) {
+	TourConstraints constraints;
+	constraints.type = type;
+	constraints.maxConflicts = maxConflicts;
+	std::vector<int> moves = board.moves_made();
+	for(int i = 0; i <= board.current_move(); ++i)
+		constraints.numbers.emplace_back(moves[i], i + 1);
+
+	std::vector<uint32_t> tour;
+	SatStatus status = sat_tour(board.graph(), constraints, tour).status;
+	if(status == SatStatus::Satisfiable) {
+		for(size_t i = board.current_move() + 1; i < tour.size(); ++i)
+			board.make_move(tour[i]);
+	}
+	return status;
 }
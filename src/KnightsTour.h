@@ -2,35 +2,36 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <string>
 #include <cassert>
 #include <vector>
 
-#include "Tile.h"
-
-constexpr uint8_t rows = 8;     // Total number of rows on a chess board.
-constexpr uint8_t columns = 8;  // Total number of columns on a chess board.
+#include "BoardState.h"
+#include "SatTour.h"
+#include "Warnsdorff.h"
 
+// Chess notation helpers and console output for the game. Game state lives in BoardState.
 class KnightsTour {
 public:
-	inline static std::array<Tile, rows * columns> chessboard{};
-	inline static std::vector<int> movesMade {};
-	inline static std::vector<int>::iterator currentMoveItr;
-	inline static bool isFirstMoveMade = false;
-	static inline bool visitableTileExists = true;
-	static void make_move(const std::vector<int>::iterator& currentMoveItr);
-	static void undo_move();
-	static void redo_move();
-	static void set_current_move_iterator(int index);
-	static bool is_valid_letter(char letter);
-	static bool is_valid_number(char number);
-	static int chess_notation_to_index(std::string input);
-	static std::string index_to_chess_notation(int index);
-	static void calculate_visitable_tile(const std::vector<int>::iterator& currentMoveItr);
-	static bool enforce_next_move(int index);
-	static void print_chessboard();
-	static void clear_screen();
+	// Notation is column letters followed by a row number. Columns go A-Z, then AA, AB and so
+	// on for wider boards, the way spreadsheets name them.
+	static bool is_valid_letter(char letter, int boardColumns = columns);
+	static bool is_valid_number(int number, int boardRows = rows);
+	static int64_t chess_notation_to_index(std::string input, int boardRows = rows, int boardColumns = columns);
+	static std::string index_to_chess_notation(int64_t index, int boardColumns = columns);
+	static void print_chessboard(const BoardState& board);
+
+	// Clears board and plays a Warnsdorff tour from index into its move history, so the
+	// result can be stepped through with undo/redo. Returns true if every tile was visited.
+	static bool solve_from(BoardState& board, int index, TieBreak tieBreak = TieBreak::FirstFound, uint64_t seed = 0);
+
+	// Finishes the tour from the current position with the SAT engine, keeping the moves made
+	// so far. Unlike Warnsdorff it only fails if no tour continues this line, or maxConflicts
+	// runs out. The new moves are appended to the move history.
+	static SatStatus complete_tour(BoardState& board, TourType type = TourType::Open, uint64_t maxConflicts = 0);
 
 	KnightsTour() = delete;
 
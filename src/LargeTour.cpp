@@ -0,0 +1,284 @@
+#include "LargeTour.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "KnightsTour.h"
+
+namespace {
+
+// Closed tours of every block shape, as tile indices (columns * row + column) in tour order.
+// Each one contains the corner edges listed in cornerEdges at all four corners.
+// 6 rows x 6 columns
+constexpr uint8_t tour6x6[] = {
+	0, 8, 4, 17, 28, 32, 24, 20, 31, 18, 7, 3, 11, 15, 2, 10, 23, 34, 26, 30, 19, 6, 14, 27, 35, 22,
+	33, 25, 12, 1, 9, 5, 16, 29, 21, 13
+};
+
+// 6 rows x 8 columns
+constexpr uint8_t tour6x8[] = {
+	0, 10, 16, 33, 43, 37, 47, 30, 15, 5, 20, 3, 9, 24, 41, 26, 32, 42, 36, 46, 31, 14, 4, 21, 6, 23,
+	38, 44, 27, 12, 29, 39, 22, 7, 13, 19, 2, 8, 25, 40, 34, 28, 45, 35, 18, 1, 11, 17
+};
+
+// 6 rows x 10 columns
+constexpr uint8_t tour6x10[] = {
+	0, 12, 20, 41, 53, 45, 57, 49, 28, 9, 17, 5, 13, 1, 22, 10, 2, 14, 6, 18, 39, 58, 37, 29, 48, 56,
+	44, 25, 4, 16, 8, 27, 19, 7, 26, 38, 59, 47, 35, 54, 46, 34, 55, 36, 15, 23, 31, 50, 42, 30, 11,
+	3, 24, 43, 51, 32, 40, 52, 33, 21
+};
+
+// 8 rows x 6 columns
+constexpr uint8_t tour8x6[] = {
+	0, 8, 4, 17, 9, 5, 16, 3, 7, 18, 31, 42, 38, 46, 35, 27, 23, 10, 2, 6, 14, 1, 12, 25, 36, 44, 40,
+	29, 21, 34, 47, 39, 43, 30, 19, 32, 45, 37, 24, 20, 33, 41, 28, 15, 11, 22, 26, 13
+};
+
+// 8 rows x 8 columns
+constexpr uint8_t tour8x8[] = {
+	0, 10, 16, 1, 11, 5, 15, 30, 47, 62, 52, 58, 48, 33, 50, 56, 41, 24, 9, 3, 13, 7, 22, 39, 54, 60,
+	45, 55, 61, 51, 57, 40, 25, 8, 2, 12, 18, 35, 20, 26, 32, 49, 59, 42, 27, 37, 43, 28, 38, 44, 29,
+	23, 6, 21, 4, 14, 31, 46, 63, 53, 36, 19, 34, 17
+};
+
+// 8 rows x 10 columns
+constexpr uint8_t tour8x10[] = {
+	0, 12, 20, 1, 13, 5, 17, 9, 28, 49, 68, 76, 64, 72, 60, 41, 62, 70, 51, 30, 11, 3, 22, 10, 2, 14,
+	6, 18, 39, 58, 79, 67, 75, 63, 71, 50, 31, 43, 55, 74, 66, 78, 59, 47, 26, 7, 19, 38, 57, 69, 77,
+	65, 73, 61, 40, 52, 33, 54, 46, 25, 4, 23, 35, 16, 8, 27, 15, 36, 48, 29, 37, 56, 44, 32, 24, 45,
+	53, 34, 42, 21
+};
+
+// 10 rows x 6 columns
+constexpr uint8_t tour10x6[] = {
+	0, 8, 4, 17, 9, 5, 16, 3, 7, 18, 31, 42, 55, 51, 59, 46, 35, 22, 11, 15, 2, 10, 23, 27, 19, 6, 14,
+	1, 12, 20, 28, 41, 52, 56, 48, 44, 57, 49, 36, 25, 33, 29, 40, 53, 45, 58, 47, 39, 50, 54, 43, 32,
+	21, 34, 38, 30, 26, 37, 24, 13
+};
+
+// 10 rows x 8 columns
+constexpr uint8_t tour10x8[] = {
+	0, 10, 16, 1, 11, 5, 15, 30, 47, 62, 79, 69, 75, 65, 48, 33, 50, 40, 25, 8, 2, 12, 6, 23, 13, 7,
+	22, 39, 54, 71, 77, 60, 45, 55, 70, 76, 66, 72, 57, 74, 64, 49, 59, 42, 32, 26, 43, 28, 18, 3, 9,
+	24, 34, 19, 4, 14, 31, 21, 38, 44, 29, 46, 63, 78, 61, 67, 73, 56, 41, 51, 36, 53, 68, 58, 52, 35,
+	20, 37, 27, 17
+};
+
+// 10 rows x 10 columns
+constexpr uint8_t tour10x10[] = {
+	0, 12, 20, 1, 13, 5, 17, 9, 28, 49, 68, 89, 97, 85, 93, 81, 60, 41, 22, 10, 2, 14, 6, 18, 39, 58,
+	79, 98, 77, 96, 88, 69, 48, 29, 8, 27, 19, 7, 26, 38, 59, 47, 66, 87, 99, 78, 86, 94, 73, 92, 80,
+	61, 40, 32, 51, 30, 11, 3, 15, 34, 53, 72, 91, 70, 82, 90, 71, 50, 31, 52, 33, 25, 4, 16, 37, 45,
+	24, 36, 57, 65, 84, 76, 95, 74, 55, 67, 46, 54, 62, 83, 75, 63, 44, 56, 64, 43, 35, 23, 42, 21
+};
+
+// Edges every block tour contains around each corner, as (row, column, row, column) measured
+// from the corner. The first two are forced anyway; the last two are what makes two blocks
+// joinable across any shared side.
+constexpr int cornerEdges[4][4] = { { 0, 0, 1, 2 }, { 0, 0, 2, 1 }, { 1, 1, 3, 0 }, { 1, 1, 0, 3 } };
+
+struct BlockShape {
+	int rows;
+	int columns;
+	std::array<uint8_t, 100> next;
+	std::array<uint8_t, 100> previous;
+};
+
+BlockShape make_shape(int rows, int columns, const uint8_t* tour) {
+	BlockShape shape{ rows, columns, {}, {} };
+	const int tileCount = rows * columns;
+	for(int i = 0; i < tileCount; ++i) {
+		shape.next[tour[i]] = tour[(i + 1) % tileCount];
+		shape.previous[tour[i]] = tour[(i + tileCount - 1) % tileCount];
+	}
+	return shape;
+}
+
+// Indexed by 3 * ((rows - 6) / 2) + (columns - 6) / 2.
+const std::array<BlockShape, 9>& block_shapes() {
+	static const std::array<BlockShape, 9> shapes = {
+		make_shape(6, 6, tour6x6), make_shape(6, 8, tour6x8), make_shape(6, 10, tour6x10),
+		make_shape(8, 6, tour8x6), make_shape(8, 8, tour8x8), make_shape(8, 10, tour8x10),
+		make_shape(10, 6, tour10x6), make_shape(10, 8, tour10x8), make_shape(10, 10, tour10x10)
+	};
+	return shapes;
+}
+
+}
+
+LargeTour::LargeTour(int rows, int columns)
+	: rowCount(rows), columnCount(columns) {
+	if(rows < 6 || columns < 6 || rows % 2 != 0 || columns % 2 != 0 || rows > maxDimension || columns > maxDimension)
+		throw std::invalid_argument("Closed tours need even board dimensions between 6 and " + std::to_string(maxDimension) + ".");
+
+	std::vector<int> rowSizes = split(rows);
+	std::vector<int> columnSizes = split(columns);
+	blockRows = static_cast<int>(rowSizes.size());
+	blockColumns = static_cast<int>(columnSizes.size());
+
+	rowToBlock.resize(rows);
+	columnToBlock.resize(columns);
+	blocks.reserve(static_cast<size_t>(blockRows) * blockColumns);
+
+	int firstRow = 0;
+	for(int blockRow = 0; blockRow < blockRows; ++blockRow) {
+		for(int row = firstRow; row < firstRow + rowSizes[blockRow]; ++row)
+			rowToBlock[row] = blockRow;
+
+		int firstColumn = 0;
+		for(int blockColumn = 0; blockColumn < blockColumns; ++blockColumn) {
+			if(blockRow == 0) {
+				for(int column = firstColumn; column < firstColumn + columnSizes[blockColumn]; ++column)
+					columnToBlock[column] = blockColumn;
+			}
+
+			Block block{};
+			block.firstRow = firstRow;
+			block.firstColumn = firstColumn;
+			block.shape = static_cast<uint8_t>(3 * ((rowSizes[blockRow] - 6) / 2) + (columnSizes[blockColumn] - 6) / 2);
+			blocks.push_back(block);
+			firstColumn += columnSizes[blockColumn];
+		}
+		firstRow += rowSizes[blockRow];
+	}
+
+	// Join the blocks in snake order: along every block row, then up at the right end after
+	// even block rows and at the left end after odd ones. Every join uses corners no other
+	// join touches, so each one merges two separate cycles into one.
+	for(int blockRow = 0; blockRow < blockRows; ++blockRow) {
+		for(int blockColumn = 0; blockColumn + 1 < blockColumns; ++blockColumn)
+			join(block_at(blockRow, blockColumn), false, true, block_at(blockRow, blockColumn + 1), false, false);
+
+		if(blockRow + 1 < blockRows) {
+			bool rightSide = blockRow % 2 == 0;
+			int blockColumn = rightSide ? blockColumns - 1 : 0;
+			join(block_at(blockRow, blockColumn), true, rightSide, block_at(blockRow + 1, blockColumn), false, rightSide);
+		}
+	}
+}
+
+// Splits a side into pieces of 6, 8 and 10, mostly 8.
+std::vector<int> LargeTour::split(int size) {
+	std::vector<int> pieces(size / 8, 8);
+	switch(size % 8) {
+	case 2:
+		pieces.back() = 10;
+		break;
+	case 4:
+		pieces.back() = 6;
+		pieces.push_back(6);
+		break;
+	case 6:
+		pieces.push_back(6);
+		break;
+	default:
+		break;
+	}
+	return pieces;
+}
+
+LargeTour::Block& LargeTour::block_at(int blockRow, int blockColumn) {
+	return blocks[static_cast<size_t>(blockRow) * blockColumns + blockColumn];
+}
+
+void LargeTour::neighbours(int64_t index, int64_t& first, int64_t& second) const {
+	int row = static_cast<int>(index / columnCount);
+	int column = static_cast<int>(index % columnCount);
+	const Block& block = blocks[static_cast<size_t>(rowToBlock[row]) * blockColumns + columnToBlock[column]];
+	const BlockShape& shape = block_shapes()[block.shape];
+
+	auto to_board = [&](int local) {
+		return static_cast<int64_t>(block.firstRow + local / shape.columns) * columnCount + block.firstColumn + local % shape.columns;
+	};
+
+	int local = (row - block.firstRow) * shape.columns + (column - block.firstColumn);
+	first = to_board(shape.next[local]);
+	second = to_board(shape.previous[local]);
+
+	for(int i = 0; i < block.rewireCount; ++i) {
+		const Rewire& rewire = block.rewires[i];
+		if(rewire.tile != index)
+			continue;
+		if(first == rewire.from)
+			first = rewire.to;
+		else if(second == rewire.from)
+			second = rewire.to;
+	}
+}
+
+void LargeTour::corner_edges(const Block& block, bool highRow, bool highColumn, std::array<std::array<int64_t, 2>, 4>& edges) const {
+	const BlockShape& shape = block_shapes()[block.shape];
+	auto to_board = [&](int row, int column) {
+		if(highRow)
+			row = shape.rows - 1 - row;
+		if(highColumn)
+			column = shape.columns - 1 - column;
+		return static_cast<int64_t>(block.firstRow + row) * columnCount + block.firstColumn + column;
+	};
+
+	for(int i = 0; i < 4; ++i) {
+		edges[i][0] = to_board(cornerEdges[i][0], cornerEdges[i][1]);
+		edges[i][1] = to_board(cornerEdges[i][2], cornerEdges[i][3]);
+	}
+}
+
+bool LargeTour::is_knight_move(int64_t from, int64_t to) const {
+	int64_t rowDelta = from / columnCount - to / columnCount;
+	int64_t columnDelta = from % columnCount - to % columnCount;
+	return rowDelta * rowDelta + columnDelta * columnDelta == 5;
+}
+
+void LargeTour::join(Block& first, bool firstHighRow, bool firstHighColumn, Block& second, bool secondHighRow, bool secondHighColumn) {
+	std::array<std::array<int64_t, 2>, 4> firstEdges;
+	std::array<std::array<int64_t, 2>, 4> secondEdges;
+	corner_edges(first, firstHighRow, firstHighColumn, firstEdges);
+	corner_edges(second, secondHighRow, secondHighColumn, secondEdges);
+
+	auto in_tour = [&](const std::array<int64_t, 2>& edge) {
+		int64_t a;
+		int64_t b;
+		neighbours(edge[0], a, b);
+		return a == edge[1] || b == edge[1];
+	};
+
+	// Drop edge (a1, a2) from the first block and (b1, b2) from the second, then connect
+	// a1-b1 and a2-b2 across the border.
+	for(const auto& firstEdge : firstEdges) {
+		if(in_tour(firstEdge) == false)
+			continue;
+		for(const auto& secondEdge : secondEdges) {
+			if(in_tour(secondEdge) == false)
+				continue;
+			for(int flip = 0; flip < 2; ++flip) {
+				int64_t a1 = firstEdge[0];
+				int64_t a2 = firstEdge[1];
+				int64_t b1 = secondEdge[flip];
+				int64_t b2 = secondEdge[1 - flip];
+				if(is_knight_move(a1, b1) == false || is_knight_move(a2, b2) == false)
+					continue;
+
+				first.rewires[first.rewireCount++] = { a1, a2, b1 };
+				first.rewires[first.rewireCount++] = { a2, a1, b2 };
+				second.rewires[second.rewireCount++] = { b1, b2, a1 };
+				second.rewires[second.rewireCount++] = { b2, b1, a2 };
+				return;
+			}
+		}
+	}
+
+	throw std::logic_error("Knight's tour blocks could not be joined.");
+}
+
+void LargeTour::write(std::ostream& out) const {
+	std::string buffer;
+	buffer.reserve(1 << 16);
+	for_each_tile([&](int64_t index) {
+		buffer += KnightsTour::index_to_chess_notation(index, columnCount);
+		buffer += '\n';
+		if(buffer.size() >= (1 << 16) - 16) {
+			out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	});
+	out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Closed knight's tour for very large boards, built in time linear in the number of tiles
+// by divide and conquer (after Parberry, "An efficient algorithm for the Knight's tour
+// problem", 1997).
+//
+// The board is cut into blocks that are 6, 8 or 10 tiles on each side. Every block shape has
+// a precomputed closed tour that contains the same fixed edges around each of its four
+// corners. Neighbouring blocks are joined in snake order by swapping one corner edge of each
+// block for two edges that cross the border between them, which merges the two cycles.
+//
+// The tour is never stored. The two neighbours of a tile in the tour come from its block's
+// table plus the few swapped edges, so walking the tour only needs memory proportional to the
+// number of blocks. Both dimensions must be even and at least 6.
+class LargeTour {
+public:
+	// Memory is one Block (112 bytes) per block of mostly 8x8 tiles, so 10000x10000 takes about
+	// 1.6 million blocks and 175 MB. Every doubling of the side quadruples that.
+	static constexpr int maxDimension = 10000;
+
+	LargeTour(int rows, int columns);
+
+	int rows() const { return rowCount; }
+	int columns() const { return columnCount; }
+	int64_t tile_count() const { return static_cast<int64_t>(rowCount) * columnCount; }
+
+	// Calls f(index) for every tile in tour order, starting at tile 0 (A1).
+	// The last tile is a knight's move away from A1.
+	template <typename Function>
+	void for_each_tile(Function&& f) const;
+
+	// Streams the tour in chess notation, one tile per line.
+	void write(std::ostream& out) const;
+
+	// The two tiles next to index in the tour.
+	void neighbours(int64_t index, int64_t& first, int64_t& second) const;
+
+private:
+	// A tile whose tour neighbour from was replaced by to when two blocks were joined.
+	struct Rewire {
+		int64_t tile;
+		int64_t from;
+		int64_t to;
+	};
+
+	struct Block {
+		int firstRow;
+		int firstColumn;
+		uint8_t shape;
+		uint8_t rewireCount;
+		std::array<Rewire, 4> rewires;	// A block is joined to at most two others.
+	};
+
+	static std::vector<int> split(int size);
+	Block& block_at(int blockRow, int blockColumn);
+	void join(Block& first, bool firstHighRow, bool firstHighColumn, Block& second, bool secondHighRow, bool secondHighColumn);
+	void corner_edges(const Block& block, bool highRow, bool highColumn, std::array<std::array<int64_t, 2>, 4>& edges) const;
+	bool is_knight_move(int64_t from, int64_t to) const;
+
+	int rowCount;
+	int columnCount;
+	int blockRows;
+	int blockColumns;
+	std::vector<Block> blocks;
+	std::vector<int> rowToBlock;	// Block row of every board row.
+	std::vector<int> columnToBlock;	// Block column of every board column.
+};
+
+template <typename Function>
+void LargeTour::for_each_tile(Function&& f) const {
+	int64_t first;
+	int64_t second;
+	neighbours(0, first, second);
+
+	int64_t previous = second;
+	int64_t current = 0;
+	const int64_t tileCount = tile_count();
+	for(int64_t i = 0; i < tileCount; ++i) {
+		f(current);
+		neighbours(current, first, second);
+		int64_t next = first == previous ? second : first;
+		previous = current;
+		current = next;
+	}
+}
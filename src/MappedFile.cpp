@@ -0,0 +1,69 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("Could not open " + path + ".");
+	fileHandle = file;
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(file, &size);
+	fileSize = static_cast<size_t>(size.QuadPart);
+	if(fileSize > 0) {
+		mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(mappingHandle)
+			fileData = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	}
+#else
+	fileDescriptor = open(path.c_str(), O_RDONLY);
+	if(fileDescriptor < 0)
+		throw std::runtime_error("Could not open " + path + ".");
+
+	struct stat status;
+	fstat(fileDescriptor, &status);
+	fileSize = static_cast<size_t>(status.st_size);
+	if(fileSize > 0) {
+		void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if(mapping != MAP_FAILED) {
+			fileData = static_cast<const uint8_t*>(mapping);
+			// Tour files are read front to back.
+			madvise(mapping, fileSize, MADV_SEQUENTIAL);
+		}
+	}
+#endif
+
+	if(fileSize > 0 && fileData == nullptr) {
+		this->~MappedFile();
+		throw std::runtime_error("Could not map " + path + ".");
+	}
+}
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+	if(fileData)
+		UnmapViewOfFile(fileData);
+	if(mappingHandle)
+		CloseHandle(mappingHandle);
+	if(fileHandle)
+		CloseHandle(fileHandle);
+#else
+	if(fileData)
+		munmap(const_cast<uint8_t*>(fileData), fileSize);
+	if(fileDescriptor >= 0)
+		close(fileDescriptor);
+#endif
+	fileData = nullptr;
+}
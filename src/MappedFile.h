@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read only memory mapping of a whole file. Throws std::runtime_error if the file cannot be
+// opened. Empty files map to a null data() with size() zero.
+class MappedFile {
+public:
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const uint8_t* data() const { return fileData; }
+	size_t size() const { return fileSize; }
+
+private:
+	const uint8_t* fileData = nullptr;
+	size_t fileSize = 0;
+#if defined(_WIN32)
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+};
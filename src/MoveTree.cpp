@@ -0,0 +1,34 @@
+#include "MoveTree.h"
+
+MoveTree::MoveTree() {
+	nodes.push_back(Node{ none, none, none, 0, 0 });
+}
+
+MoveTree::NodeId MoveTree::add(NodeId parent, int square) {
+	for(NodeId child = nodes[parent].firstChild; child != none; child = nodes[child].nextSibling) {
+		if(nodes[child].square == square) {
+			promote(child);
+			return child;
+		}
+	}
+
+	NodeId child = static_cast<NodeId>(nodes.size());
+	nodes.push_back(Node{ parent, none, nodes[parent].firstChild, static_cast<uint16_t>(square),
+		static_cast<uint16_t>(nodes[parent].depth + 1) });
+	nodes[parent].firstChild = child;
+	return child;
+}
+
+void MoveTree::promote(NodeId node) {
+	Node& parentNode = nodes[nodes[node].parent];
+	if(parentNode.firstChild == node)
+		return;
+
+	// Unlink from the sibling list, at most seven steps for a knight, and relink at the front.
+	NodeId previous = parentNode.firstChild;
+	while(nodes[previous].nextSibling != node)
+		previous = nodes[previous].nextSibling;
+	nodes[previous].nextSibling = nodes[node].nextSibling;
+	nodes[node].nextSibling = parentNode.firstChild;
+	parentNode.firstChild = node;
+}
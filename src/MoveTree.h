@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Every line of play explored in a game, as a tree of moves kept in one array.
+// Nodes refer to each other by index, so references stay valid as the array grows, and a
+// node is 16 bytes, so a million move session costs 16 MB. Making a move that was already
+// explored from the same position reuses its node instead of adding another.
+//
+// The children of a node are a linked list with the most recently used child first, which
+// is the one redo follows.
+class MoveTree {
+public:
+	using NodeId = uint32_t;
+	static constexpr NodeId root = 0;			// Position before the first move.
+	static constexpr NodeId none = UINT32_MAX;
+
+	MoveTree();
+
+	// Child of parent moving to square, added if it does not exist yet. Becomes the redo child.
+	NodeId add(NodeId parent, int square);
+
+	// Makes node the child redo follows from its parent.
+	void promote(NodeId node);
+
+	NodeId parent(NodeId node) const { return nodes[node].parent; }
+	NodeId redo_child(NodeId node) const { return nodes[node].firstChild; }
+	NodeId first_child(NodeId node) const { return nodes[node].firstChild; }
+	NodeId next_sibling(NodeId node) const { return nodes[node].nextSibling; }
+	int square(NodeId node) const { return nodes[node].square; }
+	int depth(NodeId node) const { return nodes[node].depth; }	// Moves from the root, 0 for the root.
+
+	size_t size() const { return nodes.size(); }
+	size_t memory_bytes() const { return nodes.capacity() * sizeof(Node); }
+
+private:
+	struct Node {
+		NodeId parent;
+		NodeId firstChild;
+		NodeId nextSibling;
+		uint16_t square;
+		uint16_t depth;
+	};
+
+	static_assert(sizeof(Node) == 16, "Move tree nodes should stay 16 bytes.");
+
+	std::vector<Node> nodes;
+};
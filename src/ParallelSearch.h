@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Backtracking.h"
+#include "WorkStealingQueue.h"
+
+struct ParallelOptions {
+	int threads = 0;			// Worker threads, 0 uses every hardware thread.
+	int splitDepth = 3;			// Plies searched up front to cut the search into tasks.
+	bool deterministic = false;	// Limits apply per task and results merge in task order.
+	MagicConstraint magic = MagicConstraint::None;
+	SearchLimits limits;
+	TranspositionTable* table = nullptr;	// Shared by all workers in count when set.
+};
+
+struct ParallelStats {
+	uint64_t nodes = 0;
+	uint64_t tours = 0;			// Tours handed to the callback, or counted.
+	bool completed = true;		// False if a tour was turned away or part of the tree was not searched.
+	uint64_t tableProbes = 0;
+	uint64_t tableHits = 0;
+	std::vector<uint64_t> threadNodes;	// Nodes searched by each worker.
+	std::vector<uint64_t> threadTasks;	// Tasks run by each worker, including stolen ones.
+	std::vector<uint64_t> taskTours;	// Tours found per task, in task order.
+};
+
+// Runs Backtracking on every core. The tree is split at the first few plies into
+// independent tasks, which are dealt out round robin and rebalanced by work stealing.
+// Every worker searches with its own solver, so no board state is shared.
+//
+// maxNodes always applies to each task. In the default mode maxTours is shared and the
+// search stops for everyone at the first tour past that many, so finding exactly maxTours
+// still completes. In deterministic mode each task gets the full maxTours, the callback
+// returning false only ends the current task, and the merged counts are taken in task order,
+// so results do not depend on scheduling.
+template <int Rows, int Columns>
+class ParallelSearch {
+public:
+	using Solver = Backtracking<Rows, Columns>;
+	using Tour = typename Solver::Tour;
+	using Attacks = typename Solver::Attacks;
+	static constexpr int tileCount = Solver::tileCount;
+
+	explicit ParallelSearch(TourType type = TourType::Open, ParallelOptions options = {})
+		: type(type), options(options) {
+		if(this->options.threads <= 0)
+			this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+		this->options.splitDepth = std::clamp(this->options.splitDepth, 0, tileCount - 1);
+	}
+
+	// Calls onTour(int thread, const Tour&) for every tour starting at start. The callback
+	// runs on worker threads concurrently and returns false to stop the search.
+	template <typename Callback>
+	ParallelStats enumerate(int start, Callback&& onTour) {
+		return run(start, onTour, nullptr);
+	}
+
+	// Counts tours. With options.table set every worker counts through the same lock-free
+	// transposition table, so subtrees one worker finished are not searched again by another.
+	ParallelStats count(int start) {
+		return run(start, [](int, const Tour&) { return true; }, options.table);
+	}
+
+private:
+	struct Task {
+		Tour prefix;
+		int length;
+		int id;
+	};
+
+	template <typename Callback>
+	ParallelStats run(int start, Callback&& onTour, TranspositionTable* table) {
+		std::vector<Task> tasks;
+		Task root{};
+		root.prefix[0] = static_cast<uint8_t>(start);
+		root.length = 1;
+		split(root, square_bit(start), tasks);
+		for(size_t i = 0; i < tasks.size(); ++i)
+			tasks[i].id = static_cast<int>(i);
+
+		const int threads = options.threads;
+		std::vector<std::unique_ptr<WorkStealingQueue<Task>>> queues;
+		for(int i = 0; i < threads; ++i)
+			queues.push_back(std::make_unique<WorkStealingQueue<Task>>());
+		for(const Task& task : tasks)
+			queues[task.id % threads]->push(task);
+
+		ParallelStats stats;
+		stats.threadNodes.assign(threads, 0);
+		stats.threadTasks.assign(threads, 0);
+		stats.taskTours.assign(tasks.size(), 0);
+		std::vector<uint8_t> taskCompleted(tasks.size(), 1);
+
+		std::vector<uint64_t> threadProbes(threads, 0);
+		std::vector<uint64_t> threadHits(threads, 0);
+		std::atomic<uint64_t> sharedTours{ 0 };
+		std::atomic<bool> stop{ false };
+
+		auto worker = [&](int thread) {
+			// maxTours is applied below, so that only tours handed to onTour are counted.
+			Solver solver(type, SearchLimits{ 0, options.limits.maxNodes }, false, options.magic);
+			const uint64_t maxTours = options.limits.maxTours;
+			uint64_t nodes = 0;
+			Task task;
+			while(stop.load(std::memory_order_relaxed) == false && next_task(queues, thread, task)) {
+				if(table) {
+					SearchStats result = solver.count_from(task.prefix, task.length, *table);
+					nodes += result.nodes;
+					threadProbes[thread] += result.tableProbes;
+					threadHits[thread] += result.tableHits;
+					++stats.threadTasks[thread];
+					stats.taskTours[task.id] = result.tours;
+					taskCompleted[task.id] = result.completed;
+					continue;
+				}
+
+				// Returning false turns the tour away and leaves the task incomplete.
+				uint64_t delivered = 0;
+				SearchStats result = solver.enumerate_from(task.prefix, task.length, [&](const Tour& tour) {
+					if(options.deterministic) {
+						if(maxTours != 0 && delivered == maxTours)
+							return false;
+						++delivered;
+						return onTour(thread, tour);
+					}
+
+					if(stop.load(std::memory_order_relaxed))
+						return false;
+					uint64_t found = sharedTours.fetch_add(1, std::memory_order_relaxed) + 1;
+					if(maxTours != 0 && found > maxTours) {
+						stop.store(true, std::memory_order_relaxed);
+						return false;
+					}
+					++delivered;
+					if(onTour(thread, tour) == false) {
+						stop.store(true, std::memory_order_relaxed);
+						return false;
+					}
+					return true;
+				});
+
+				nodes += result.nodes;
+				++stats.threadTasks[thread];
+				stats.taskTours[task.id] = delivered;
+				taskCompleted[task.id] = result.completed;
+			}
+			stats.threadNodes[thread] = nodes;
+		};
+
+		std::vector<std::thread> workers;
+		for(int i = 1; i < threads; ++i)
+			workers.emplace_back(worker, i);
+		worker(0);
+		for(auto& thread : workers)
+			thread.join();
+
+		for(int i = 0; i < threads; ++i) {
+			stats.nodes += stats.threadNodes[i];
+			stats.tableProbes += threadProbes[i];
+			stats.tableHits += threadHits[i];
+		}
+
+		// Merge in task order so the totals never depend on which thread ran what. Ending on
+		// exactly maxTours is not a truncation, only a task that stopped early is.
+		for(size_t i = 0; i < tasks.size(); ++i) {
+			uint64_t tours = stats.taskTours[i];
+			if(options.limits.maxTours != 0 && stats.tours + tours > options.limits.maxTours) {
+				stats.tours = options.limits.maxTours;
+				stats.completed = false;
+				break;
+			}
+			stats.tours += tours;
+			if(taskCompleted[i] == 0)
+				stats.completed = false;
+		}
+		// Stopping always turns a tour away first, so the task that did is already incomplete.
+
+		return stats;
+	}
+
+	// Expands task to options.splitDepth plies and appends the resulting prefixes to tasks.
+	void split(Task& task, Bitboard visited, std::vector<Task>& tasks) const {
+		if(task.length > options.splitDepth) {
+			tasks.push_back(task);
+			return;
+		}
+
+		Bitboard candidates = Attacks::visitable(task.prefix[task.length - 1], visited);
+		while(candidates) {
+			int next = pop_lowest_square(candidates);
+			task.prefix[task.length++] = static_cast<uint8_t>(next);
+			split(task, visited | square_bit(next), tasks);
+			--task.length;
+		}
+	}
+
+	static bool next_task(std::vector<std::unique_ptr<WorkStealingQueue<Task>>>& queues, int thread, Task& task) {
+		if(queues[thread]->pop(task))
+			return true;
+
+		// All tasks exist up front, so once every queue is empty the search is done.
+		const int threads = static_cast<int>(queues.size());
+		for(int i = 1; i < threads; ++i) {
+			if(queues[(thread + i) % threads]->steal(task))
+				return true;
+		}
+		return false;
+	}
+
+	TourType type;
+	ParallelOptions options;
+};
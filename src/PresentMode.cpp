@@ -0,0 +1,91 @@
+#include "PresentMode.h"
+
+#include <algorithm>
+
+const char* present_mode_name(PresentMode mode) {
+	switch(mode) {
+	case PresentMode::VSync:
+		return "vsync";
+	case PresentMode::Uncapped:
+		return "uncapped";
+	case PresentMode::Tearing:
+		return "tearing";
+	default:
+		return "waitable";
+	}
+}
+
+PresentController::PresentController(bool tearingSupported, PresentMode mode, int maxLatency)
+	: tearingAllowed(tearingSupported), requested(mode), latency(std::clamp(maxLatency, 1, maxFrameLatency)) {}
+
+PresentMode PresentController::mode() const {
+	if(requested == PresentMode::Tearing && tearingAllowed == false)
+		return PresentMode::Uncapped;
+	return requested;
+}
+
+SwapChainChange PresentController::set_mode(PresentMode newMode) {
+	const bool wasWaitable = waitable();
+	requested = newMode;
+	return waitable() != wasWaitable ? SwapChainChange::Recreate : SwapChainChange::None;
+}
+
+SwapChainChange PresentController::next_mode() {
+	return set_mode(static_cast<PresentMode>((static_cast<int>(requested) + 1) % presentModeCount));
+}
+
+SwapChainChange PresentController::set_max_latency(int frames) {
+	frames = std::clamp(frames, 1, maxFrameLatency);
+	if(frames == latency)
+		return SwapChainChange::None;
+	latency = frames;
+	return waitable() ? SwapChainChange::SetLatency : SwapChainChange::None;
+}
+
+unsigned PresentController::sync_interval() const {
+	PresentMode current = mode();
+	return current == PresentMode::VSync || current == PresentMode::Waitable ? 1 : 0;
+}
+
+void LatencyTracker::input(double time) {
+	if(hasInput == false) {
+		hasInput = true;
+		inputTime = time;
+	}
+}
+
+void LatencyTracker::presented(uint64_t presentId, PresentMode mode) {
+	if(hasInput) {
+		waiting.push_back({ presentId, inputTime, mode });
+		hasInput = false;
+	}
+}
+
+void LatencyTracker::displayed(uint64_t presentId, double time) {
+	while(waiting.empty() == false && waiting.front().presentId < presentId) {
+		++unmeasuredCount;
+		waiting.pop_front();
+	}
+	if(waiting.empty() == false && waiting.front().presentId == presentId) {
+		const Sample& sample = waiting.front();
+		const double latency = time - sample.inputTime;
+		Stats& stats = modeStats[static_cast<int>(sample.mode)];
+		stats.min = stats.samples == 0 ? latency : std::min(stats.min, latency);
+		stats.max = stats.samples == 0 ? latency : std::max(stats.max, latency);
+		stats.total += latency;
+		stats.last = latency;
+		++stats.samples;
+		waiting.pop_front();
+	}
+}
+
+void LatencyTracker::drop_pending() {
+	hasInput = false;
+	waiting.clear();
+}
+
+void LatencyTracker::reset() {
+	drop_pending();
+	unmeasuredCount = 0;
+	modeStats = {};
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+// How frames reach the screen.
+enum class PresentMode {
+	VSync,		// Wait for vertical blank, up to the default three frames queued.
+	Uncapped,	// Present immediately, the newest frame is shown at the next vertical blank.
+	Tearing,	// Present immediately and let the flip happen mid scan out. Needs driver support.
+	Waitable	// VSync, but the CPU waits for the swap chain before each frame, at most maxLatency queued.
+};
+
+constexpr int presentModeCount = 4;
+
+const char* present_mode_name(PresentMode mode);
+
+// What a change of present settings asks of the swap chain.
+enum class SwapChainChange {
+	None,		// Only the arguments of the next Present change.
+	SetLatency,	// SetMaximumFrameLatency on the waitable swap chain.
+	Recreate	// The swap chain flags change, so it has to be created again.
+};
+
+// The present settings as a state machine. The requested mode can differ from the mode in
+// effect: tearing falls back to uncapped when the driver does not support it. Swap chains get
+// the tearing flag whenever it is supported, so that switching between the modes without a
+// waitable object only changes the Present arguments.
+class PresentController {
+public:
+	static constexpr int maxFrameLatency = 16;	// The DXGI limit.
+
+	explicit PresentController(bool tearingSupported = false, PresentMode mode = PresentMode::VSync, int maxLatency = 1);
+
+	SwapChainChange set_mode(PresentMode mode);
+	SwapChainChange next_mode();					// Cycles through the modes in declaration order.
+	SwapChainChange set_max_latency(int frames);	// Clamped to 1 to maxFrameLatency.
+
+	PresentMode requested_mode() const { return requested; }
+	PresentMode mode() const;	// The mode in effect.
+	int max_latency() const { return latency; }
+
+	// Swap chain flags and Present arguments for the mode in effect.
+	bool tearing_supported() const { return tearingAllowed; }
+	bool waitable() const { return mode() == PresentMode::Waitable; }
+	unsigned sync_interval() const;
+	bool allow_tearing() const { return mode() == PresentMode::Tearing; }
+
+private:
+	bool tearingAllowed;
+	PresentMode requested;
+	int latency;
+};
+
+// Time from an input to the frame that shows it reaching the screen, per present mode.
+//
+//     input(now)						when a click changed the board
+//     presented(presentId, mode)		after the Present of each frame
+//     displayed(presentId, time)		when the display reports a present on screen
+//
+// Several inputs before the same Present count once, from the earliest. Times are seconds
+// from any fixed point. Frame statistics only give the time of the latest present on screen,
+// so a sample is only measured when its present is the one reported. Older ones, whose own
+// time was never reported, are dropped as unmeasured instead of being charged a later vblank.
+class LatencyTracker {
+public:
+	struct Stats {
+		uint64_t samples = 0;
+		double total = 0.0;
+		double min = 0.0;
+		double max = 0.0;
+		double last = 0.0;
+
+		double mean() const { return samples != 0 ? total / samples : 0.0; }
+	};
+
+	void input(double time);
+	void presented(uint64_t presentId, PresentMode mode);
+	void displayed(uint64_t presentId, double time);	// presentId reached the screen at time.
+
+	const Stats& stats(PresentMode mode) const { return modeStats[static_cast<int>(mode)]; }
+	size_t pending() const { return waiting.size(); }
+	uint64_t unmeasured() const { return unmeasuredCount; }	// Samples dropped because their present was not the one reported.
+	void drop_pending();	// Present ids start over, e.g. on a new swap chain. Keeps the stats.
+	void reset();
+
+private:
+	struct Sample {
+		uint64_t presentId;
+		double inputTime;
+		PresentMode mode;
+	};
+
+	bool hasInput = false;
+	double inputTime = 0.0;
+	std::deque<Sample> waiting;
+	uint64_t unmeasuredCount = 0;
+	std::array<Stats, presentModeCount> modeStats{};
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// Small, fast pseudo random generator (SplitMix64). Deterministic for a given seed and
+// cheap to copy, so solvers can carry their own stream without allocating.
+struct SplitMix64 {
+	uint64_t state;
+
+	explicit SplitMix64(uint64_t seed = 0) : state(seed) {}
+
+	uint64_t next() {
+		uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// Independent stream number index derived from this one, without advancing it. The same
+	// seed and index always give the same stream, so work can be split between any number of
+	// threads and still draw the same numbers.
+	SplitMix64 split(uint64_t index) const {
+		SplitMix64 mixer(state ^ (index * 0xD1B54A32D192ED03ull));
+		return SplitMix64(mixer.next());
+	}
+
+	// Uniform value in [0, bound). bound must be greater than zero.
+	uint32_t next_below(uint32_t bound) {
+		return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+	}
+};
@@ -0,0 +1,460 @@
+#include "SatSolver.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr SatSolver::Literal noLiteral = UINT32_MAX;
+constexpr uint64_t restartBase = 100;		// Conflicts per unit of the Luby sequence.
+constexpr uint64_t firstReduce = 2000;		// Conflicts before learnt clauses are first thinned out.
+constexpr uint64_t reduceIncrement = 300;	// And how much longer each round after that waits.
+constexpr double variableDecay = 0.95;
+constexpr float clauseDecay = 0.999f;
+
+// Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ... as a power of y.
+double luby(double y, uint64_t x) {
+	uint64_t size = 1;
+	int sequence = 0;
+	while(size < x + 1) {
+		++sequence;
+		size = 2 * size + 1;
+	}
+	while(size - 1 != x) {
+		size = (size - 1) >> 1;
+		--sequence;
+		x = x % size;
+	}
+	return std::pow(y, sequence);
+}
+
+}
+
+int SatSolver::add_variable() {
+	int variable = variable_count();
+	assigns.push_back(valueUnset);
+	savedPhase.push_back(1);	// Try false first. Most variables of one-hot encodings are false.
+	levels.push_back(0);
+	reasons.push_back(noClause);
+	activity.push_back(0.0);
+	heapPosition.push_back(-1);
+	seen.push_back(0);
+	watches.emplace_back();
+	watches.emplace_back();
+	heap_insert(variable);
+	return variable;
+}
+
+bool SatSolver::add_clause(std::vector<Literal> clause) {
+	if(consistent == false)
+		return false;
+
+	// Clauses are only added at level 0, so assigned literals are final.
+	std::sort(clause.begin(), clause.end());
+	size_t kept = 0;
+	for(size_t i = 0; i < clause.size(); ++i) {
+		Literal literal = clause[i];
+		if(value_of(literal) == valueTrue || (i + 1 < clause.size() && clause[i + 1] == negate(literal)))
+			return true;	// Already satisfied, or contains x and not x.
+		if(value_of(literal) == valueFalse || (kept > 0 && clause[kept - 1] == literal))
+			continue;
+		clause[kept++] = literal;
+	}
+	clause.resize(kept);
+
+	++problemClauses;
+	if(clause.empty())
+		consistent = false;
+	else if(clause.size() == 1) {
+		assign(clause[0], noClause);
+		consistent = propagate() == noClause;
+	}
+	else
+		store_clause(clause, false, 0);
+	return consistent;
+}
+
+SatStatus SatSolver::solve(uint64_t maxConflicts) {
+	model.clear();
+	if(consistent == false)
+		return SatStatus::Unsatisfiable;
+
+	const uint64_t conflictsAtStart = statistics.conflicts;
+	uint64_t restarts = 0;
+	uint64_t restartLimit = static_cast<uint64_t>(luby(2.0, restarts) * restartBase);
+	uint64_t conflictsSinceRestart = 0;
+	uint64_t reductions = 0;
+	uint64_t nextReduce = statistics.conflicts + firstReduce;
+	std::vector<Literal> learnt;
+
+	for(;;) {
+		uint32_t conflict = propagate();
+		if(conflict != noClause) {
+			++statistics.conflicts;
+			++conflictsSinceRestart;
+			if(decision_level() == 0) {
+				consistent = false;
+				return SatStatus::Unsatisfiable;
+			}
+
+			int backtrackLevel;
+			uint32_t lbd;
+			analyze(conflict, learnt, backtrackLevel, lbd);
+			backtrack(backtrackLevel);
+			if(learnt.size() == 1)
+				assign(learnt[0], noClause);
+			else {
+				uint32_t index = store_clause(learnt, true, lbd);
+				learntList.push_back(index);
+				assign(learnt[0], index);
+			}
+			++statistics.learntClauses;
+			variableIncrement /= variableDecay;
+			clauseIncrement /= clauseDecay;
+
+			if(maxConflicts != 0 && statistics.conflicts - conflictsAtStart >= maxConflicts) {
+				backtrack(0);
+				return SatStatus::Unknown;
+			}
+			continue;
+		}
+
+		if(conflictsSinceRestart >= restartLimit) {
+			backtrack(0);
+			++statistics.restarts;
+			restartLimit = static_cast<uint64_t>(luby(2.0, ++restarts) * restartBase);
+			conflictsSinceRestart = 0;
+		}
+		if(statistics.conflicts >= nextReduce) {
+			reduce_learnt();
+			nextReduce = statistics.conflicts + firstReduce + reduceIncrement * ++reductions;
+		}
+
+		Literal next = pick_branch();
+		if(next == noLiteral) {
+			model.resize(assigns.size());
+			for(size_t i = 0; i < assigns.size(); ++i)
+				model[i] = assigns[i] == valueTrue;
+			backtrack(0);
+			return SatStatus::Satisfiable;
+		}
+		++statistics.decisions;
+		trailLimits.push_back(static_cast<int>(trail.size()));
+		assign(next, noClause);
+	}
+}
+
+uint32_t SatSolver::store_clause(const std::vector<Literal>& clause, bool learnt, uint32_t lbd) {
+	uint32_t index = static_cast<uint32_t>(clauses.size());
+	clauses.push_back(Clause{ static_cast<uint32_t>(literals.size()), static_cast<uint32_t>(clause.size()), lbd, 0.0f, learnt, false });
+	literals.insert(literals.end(), clause.begin(), clause.end());
+	watches[clause[0]].push_back(Watcher{ index, clause[1] });
+	watches[clause[1]].push_back(Watcher{ index, clause[0] });
+	return index;
+}
+
+void SatSolver::assign(Literal literal, uint32_t reason) {
+	int variable = SatSolver::variable(literal);
+	assigns[variable] = static_cast<uint8_t>(literal & 1);
+	levels[variable] = decision_level();
+	reasons[variable] = reason;
+	trail.push_back(literal);
+}
+
+// Returns the clause that became false, or noClause. The literal a clause implies is kept at
+// position 0, which conflict analysis relies on.
+uint32_t SatSolver::propagate() {
+	while(propagateHead < trail.size()) {
+		Literal falseLiteral = negate(trail[propagateHead++]);
+		std::vector<Watcher>& list = watches[falseLiteral];
+		++statistics.propagations;
+
+		size_t from = 0;
+		size_t to = 0;
+		while(from < list.size()) {
+			Watcher watcher = list[from];
+			if(value_of(watcher.blocker) == valueTrue) {
+				list[to++] = list[from++];
+				continue;
+			}
+
+			Clause& clause = clauses[watcher.clause];
+			Literal* clauseLiterals = &literals[clause.start];
+			if(clauseLiterals[0] == falseLiteral)
+				std::swap(clauseLiterals[0], clauseLiterals[1]);
+			++from;
+
+			Literal first = clauseLiterals[0];
+			Watcher kept{ watcher.clause, first };
+			if(first != watcher.blocker && value_of(first) == valueTrue) {
+				list[to++] = kept;
+				continue;
+			}
+
+			// Look for another literal to watch instead.
+			bool moved = false;
+			for(uint32_t i = 2; i < clause.size; ++i) {
+				if(value_of(clauseLiterals[i]) != valueFalse) {
+					clauseLiterals[1] = clauseLiterals[i];
+					clauseLiterals[i] = falseLiteral;
+					watches[clauseLiterals[1]].push_back(kept);
+					moved = true;
+					break;
+				}
+			}
+			if(moved)
+				continue;
+
+			// Unit or conflicting.
+			list[to++] = kept;
+			if(value_of(first) == valueFalse) {
+				while(from < list.size())
+					list[to++] = list[from++];
+				list.resize(to);
+				propagateHead = trail.size();
+				return watcher.clause;
+			}
+			assign(first, watcher.clause);
+		}
+		list.resize(to);
+	}
+	return noClause;
+}
+
+// First UIP learning: resolves the conflict with reasons from the current level until a single
+// literal of that level is left. learnt[0] is the negation of that literal, learnt[1] one from
+// the level to go back to.
+void SatSolver::analyze(uint32_t conflict, std::vector<Literal>& learnt, int& backtrackLevel, uint32_t& lbd) {
+	learnt.clear();
+	learnt.push_back(noLiteral);
+	int pathCount = 0;
+	Literal implied = noLiteral;
+	size_t index = trail.size();
+	uint32_t reason = conflict;
+
+	do {
+		Clause& clause = clauses[reason];
+		if(clause.learnt)
+			bump_clause(clause);
+		const Literal* clauseLiterals = &literals[clause.start];
+		for(uint32_t i = implied == noLiteral ? 0 : 1; i < clause.size; ++i) {
+			Literal literal = clauseLiterals[i];
+			int variable = SatSolver::variable(literal);
+			if(seen[variable] || levels[variable] == 0)
+				continue;
+			bump_variable(variable);
+			seen[variable] = 1;
+			if(levels[variable] >= decision_level())
+				++pathCount;
+			else
+				learnt.push_back(literal);
+		}
+
+		while(seen[variable(trail[--index])] == 0) {}
+		implied = trail[index];
+		reason = reasons[variable(implied)];
+		seen[variable(implied)] = 0;
+		--pathCount;
+	} while(pathCount > 0);
+	learnt[0] = negate(implied);
+
+	// Drop literals implied by the others.
+	analyzeClear.assign(learnt.begin(), learnt.end());
+	size_t kept = 1;
+	for(size_t i = 1; i < learnt.size(); ++i) {
+		if(is_redundant(learnt[i]) == false)
+			learnt[kept++] = learnt[i];
+	}
+	learnt.resize(kept);
+	for(Literal literal : analyzeClear)
+		seen[variable(literal)] = 0;
+
+	backtrackLevel = 0;
+	if(learnt.size() > 1) {
+		size_t highest = 1;
+		for(size_t i = 2; i < learnt.size(); ++i) {
+			if(levels[variable(learnt[i])] > levels[variable(learnt[highest])])
+				highest = i;
+		}
+		std::swap(learnt[1], learnt[highest]);
+		backtrackLevel = levels[variable(learnt[1])];
+	}
+
+	std::vector<int> clauseLevels;
+	clauseLevels.reserve(learnt.size());
+	for(Literal literal : learnt)
+		clauseLevels.push_back(levels[variable(literal)]);
+	std::sort(clauseLevels.begin(), clauseLevels.end());
+	lbd = static_cast<uint32_t>(std::unique(clauseLevels.begin(), clauseLevels.end()) - clauseLevels.begin());
+}
+
+// A learnt literal is redundant if everything that implied it is in the clause already.
+bool SatSolver::is_redundant(Literal literal) const {
+	uint32_t reason = reasons[variable(literal)];
+	if(reason == noClause)
+		return false;
+	const Clause& clause = clauses[reason];
+	const Literal* clauseLiterals = &literals[clause.start];
+	for(uint32_t i = 1; i < clause.size; ++i) {
+		int variable = SatSolver::variable(clauseLiterals[i]);
+		if(seen[variable] == 0 && levels[variable] > 0)
+			return false;
+	}
+	return true;
+}
+
+void SatSolver::backtrack(int level) {
+	if(decision_level() <= level)
+		return;
+	for(size_t i = trail.size(); i-- > static_cast<size_t>(trailLimits[level]); ) {
+		int variable = SatSolver::variable(trail[i]);
+		savedPhase[variable] = static_cast<uint8_t>(trail[i] & 1);
+		assigns[variable] = valueUnset;
+		reasons[variable] = noClause;
+		heap_insert(variable);
+	}
+	trail.resize(trailLimits[level]);
+	trailLimits.resize(level);
+	propagateHead = trail.size();
+}
+
+SatSolver::Literal SatSolver::pick_branch() {
+	while(heap.empty() == false) {
+		int variable = heap_pop();
+		if(assigns[variable] == valueUnset)
+			return savedPhase[variable] ? negative(variable) : positive(variable);
+	}
+	return noLiteral;
+}
+
+bool SatSolver::is_locked(uint32_t index) const {
+	Literal first = literals[clauses[index].start];
+	return reasons[variable(first)] == index && value_of(first) == valueTrue;
+}
+
+// Deletes the less useful half of the learnt clauses: highest LBD first, then lowest
+// activity. Clauses of LBD 2 or less are kept for good. Then compacts the clause storage and
+// rebuilds the watch lists.
+void SatSolver::reduce_learnt() {
+	std::vector<uint32_t> candidates;
+	for(uint32_t index : learntList) {
+		if(clauses[index].lbd > 2 && is_locked(index) == false)
+			candidates.push_back(index);
+	}
+	std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+		if(clauses[a].lbd != clauses[b].lbd)
+			return clauses[a].lbd > clauses[b].lbd;
+		return clauses[a].activity < clauses[b].activity;
+	});
+	for(size_t i = 0; i < candidates.size() / 2; ++i)
+		clauses[candidates[i]].deleted = true;
+
+	std::vector<uint32_t> newIndex(clauses.size(), noClause);
+	std::vector<Clause> keptClauses;
+	std::vector<Literal> keptLiterals;
+	keptClauses.reserve(clauses.size());
+	keptLiterals.reserve(literals.size());
+	for(uint32_t i = 0; i < clauses.size(); ++i) {
+		Clause clause = clauses[i];
+		if(clause.deleted)
+			continue;
+		newIndex[i] = static_cast<uint32_t>(keptClauses.size());
+		keptLiterals.insert(keptLiterals.end(), literals.begin() + clause.start, literals.begin() + clause.start + clause.size);
+		clause.start = static_cast<uint32_t>(keptLiterals.size() - clause.size);
+		keptClauses.push_back(clause);
+	}
+	clauses.swap(keptClauses);
+	literals.swap(keptLiterals);
+
+	for(Literal literal : trail) {
+		uint32_t& reason = reasons[variable(literal)];
+		if(reason != noClause)
+			reason = newIndex[reason];
+	}
+	size_t keptLearnt = 0;
+	for(uint32_t index : learntList) {
+		if(newIndex[index] != noClause)
+			learntList[keptLearnt++] = newIndex[index];
+	}
+	learntList.resize(keptLearnt);
+
+	for(std::vector<Watcher>& list : watches)
+		list.clear();
+	for(uint32_t i = 0; i < clauses.size(); ++i) {
+		const Literal* clauseLiterals = &literals[clauses[i].start];
+		watches[clauseLiterals[0]].push_back(Watcher{ i, clauseLiterals[1] });
+		watches[clauseLiterals[1]].push_back(Watcher{ i, clauseLiterals[0] });
+	}
+}
+
+void SatSolver::bump_variable(int variable) {
+	activity[variable] += variableIncrement;
+	if(activity[variable] > 1e100) {
+		for(double& value : activity)
+			value *= 1e-100;
+		variableIncrement *= 1e-100;
+	}
+	if(heapPosition[variable] >= 0)
+		heap_up(heapPosition[variable]);
+}
+
+void SatSolver::bump_clause(Clause& clause) {
+	clause.activity += clauseIncrement;
+	if(clause.activity > 1e20f) {
+		for(uint32_t index : learntList)
+			clauses[index].activity *= 1e-20f;
+		clauseIncrement *= 1e-20f;
+	}
+}
+
+void SatSolver::heap_insert(int variable) {
+	if(heapPosition[variable] >= 0)
+		return;
+	heapPosition[variable] = static_cast<int>(heap.size());
+	heap.push_back(variable);
+	heap_up(heapPosition[variable]);
+}
+
+int SatSolver::heap_pop() {
+	int top = heap[0];
+	heap[0] = heap.back();
+	heapPosition[heap[0]] = 0;
+	heap.pop_back();
+	heapPosition[top] = -1;
+	if(heap.empty() == false)
+		heap_down(0);
+	return top;
+}
+
+void SatSolver::heap_up(int position) {
+	int variable = heap[position];
+	while(position > 0) {
+		int parent = (position - 1) >> 1;
+		if(activity[heap[parent]] >= activity[variable])
+			break;
+		heap[position] = heap[parent];
+		heapPosition[heap[position]] = position;
+		position = parent;
+	}
+	heap[position] = variable;
+	heapPosition[variable] = position;
+}
+
+void SatSolver::heap_down(int position) {
+	int variable = heap[position];
+	int size = static_cast<int>(heap.size());
+	for(;;) {
+		int child = 2 * position + 1;
+		if(child >= size)
+			break;
+		if(child + 1 < size && activity[heap[child + 1]] > activity[heap[child]])
+			++child;
+		if(activity[heap[child]] <= activity[variable])
+			break;
+		heap[position] = heap[child];
+		heapPosition[heap[position]] = position;
+		position = child;
+	}
+	heap[position] = variable;
+	heapPosition[variable] = position;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class SatStatus {
+	Satisfiable,
+	Unsatisfiable,
+	Unknown		// Gave up at the conflict limit.
+};
+
+struct SatStats {
+	uint64_t decisions = 0;
+	uint64_t propagations = 0;	// Literals whose watch lists were visited.
+	uint64_t conflicts = 0;
+	uint64_t restarts = 0;
+	uint64_t learntClauses = 0;	// Learnt in total, including ones deleted again.
+};
+
+// Small conflict driven clause learning SAT solver, bundled so exact searches need no external
+// tools. The usual MiniSat design:
+//  - two watched literals per clause, with a blocker literal to skip satisfied clauses,
+//  - first UIP conflict analysis with learnt clause minimisation,
+//  - VSIDS branching on a binary heap with phase saving,
+//  - Luby restarts, and learnt clause deletion that keeps clauses of low LBD (glue).
+//
+// Literals are 2 * variable for the variable and 2 * variable + 1 for its negation.
+class SatSolver {
+public:
+	using Literal = uint32_t;
+
+	static Literal positive(int variable) { return static_cast<Literal>(variable) << 1; }
+	static Literal negative(int variable) { return (static_cast<Literal>(variable) << 1) | 1; }
+	static Literal negate(Literal literal) { return literal ^ 1; }
+	static int variable(Literal literal) { return static_cast<int>(literal >> 1); }
+
+	int add_variable();
+	int variable_count() const { return static_cast<int>(assigns.size()); }
+	size_t clause_count() const { return problemClauses; }
+
+	// Adds a clause of the problem. Returns false once the problem is known to be
+	// unsatisfiable, after which further clauses are ignored.
+	bool add_clause(std::vector<Literal> literals);
+
+	// Searches for a satisfying assignment. A limit of 0 means no limit.
+	SatStatus solve(uint64_t maxConflicts = 0);
+
+	// Value of a variable in the assignment found by the last successful solve.
+	bool value(int variable) const { return model[variable] != 0; }
+
+	const SatStats& stats() const { return statistics; }
+
+private:
+	static constexpr uint8_t valueTrue = 0;
+	static constexpr uint8_t valueFalse = 1;
+	static constexpr uint8_t valueUnset = 2;
+	static constexpr uint32_t noClause = UINT32_MAX;
+
+	struct Clause {
+		uint32_t start;		// First literal in literals.
+		uint32_t size;
+		uint32_t lbd;		// Distinct decision levels when learnt.
+		float activity;
+		bool learnt;
+		bool deleted;
+	};
+
+	struct Watcher {
+		uint32_t clause;
+		Literal blocker;	// Some other literal of the clause. If true the clause is satisfied.
+	};
+
+	uint8_t value_of(Literal literal) const {
+		uint8_t assigned = assigns[literal >> 1];
+		return assigned == valueUnset ? valueUnset : assigned ^ static_cast<uint8_t>(literal & 1);
+	}
+	int decision_level() const { return static_cast<int>(trailLimits.size()); }
+
+	uint32_t store_clause(const std::vector<Literal>& clause, bool learnt, uint32_t lbd);
+	void assign(Literal literal, uint32_t reason);
+	uint32_t propagate();
+	void analyze(uint32_t conflict, std::vector<Literal>& learnt, int& backtrackLevel, uint32_t& lbd);
+	bool is_redundant(Literal literal) const;
+	void backtrack(int level);
+	Literal pick_branch();
+	void reduce_learnt();
+	bool is_locked(uint32_t clause) const;
+
+	void bump_variable(int variable);
+	void bump_clause(Clause& clause);
+	void heap_insert(int variable);
+	int heap_pop();
+	void heap_up(int position);
+	void heap_down(int position);
+
+	std::vector<uint8_t> assigns;
+	std::vector<uint8_t> savedPhase;
+	std::vector<int> levels;
+	std::vector<uint32_t> reasons;
+	std::vector<Literal> trail;
+	std::vector<int> trailLimits;
+	size_t propagateHead = 0;
+
+	std::vector<Clause> clauses;
+	std::vector<Literal> literals;			// Every clause's literals, one after another.
+	std::vector<std::vector<Watcher>> watches;	// Per literal, clauses watching it.
+	std::vector<uint32_t> learntList;
+	size_t problemClauses = 0;
+
+	std::vector<double> activity;
+	std::vector<int> heap;
+	std::vector<int> heapPosition;			// -1 when not in the heap.
+	double variableIncrement = 1.0;
+	float clauseIncrement = 1.0f;
+
+	std::vector<uint8_t> seen;
+	std::vector<Literal> analyzeClear;
+	std::vector<uint8_t> model;
+	bool consistent = true;
+	SatStats statistics;
+};
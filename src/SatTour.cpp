@@ -0,0 +1,169 @@
+#include "SatTour.h"
+
+namespace {
+
+using Literal = SatSolver::Literal;
+
+// At most one of literals. Small sets get a clause per pair, larger ones Sinz's sequential
+// counter, which adds a variable per literal meaning "one of the literals so far is true" and
+// needs 3n clauses instead of n^2 / 2. Both propagate as soon as one literal is true.
+void add_at_most_one(SatSolver& solver, const std::vector<Literal>& literals) {
+	const size_t count = literals.size();
+	if(count <= 5) {
+		for(size_t i = 0; i < count; ++i) {
+			for(size_t j = i + 1; j < count; ++j)
+				solver.add_clause({ SatSolver::negate(literals[i]), SatSolver::negate(literals[j]) });
+		}
+		return;
+	}
+
+	Literal previous = SatSolver::positive(solver.add_variable());
+	solver.add_clause({ SatSolver::negate(literals[0]), previous });
+	for(size_t i = 1; i + 1 < count; ++i) {
+		Literal current = SatSolver::positive(solver.add_variable());
+		solver.add_clause({ SatSolver::negate(literals[i]), current });
+		solver.add_clause({ SatSolver::negate(previous), current });
+		solver.add_clause({ SatSolver::negate(literals[i]), SatSolver::negate(previous) });
+		previous = current;
+	}
+	solver.add_clause({ SatSolver::negate(literals[count - 1]), SatSolver::negate(previous) });
+}
+
+}
+
+// Variable x(i, k) says open tile i is visited on move k + 1, and the clauses say:
+//  - every tile gets exactly one move number and every move number exactly one tile,
+//  - the tile of move k + 1 is a knight's move from the tiles of moves k and k + 2, wrapping
+//    around for closed tours,
+//  - where knight's moves alternate colours, one extra variable, the colour of the first
+//    tile, rules out half the numbers for every tile,
+//  - pre-placed numbers are unit clauses.
+// Every closed tour can be rotated to start anywhere, so without pre-placed numbers the first
+// open tile is fixed as move 1.
+SatTourStats sat_tour(const BoardGraph& graph, const TourConstraints& constraints, std::vector<uint32_t>& tour) {
+	tour.clear();
+	SatTourStats stats;
+	const int tileCount = graph.tile_count();
+
+	std::vector<int> openIndex(tileCount, 0);
+	for(int tile = 0; tile < tileCount; ++tile) {
+		if(graph.is_open(tile) == false)
+			openIndex[tile] = -1;
+	}
+	for(int tile : constraints.blocked) {
+		if(tile >= 0 && tile < tileCount)
+			openIndex[tile] = -1;
+	}
+	std::vector<int> openTiles;
+	for(int tile = 0; tile < tileCount; ++tile) {
+		if(openIndex[tile] >= 0) {
+			openIndex[tile] = static_cast<int>(openTiles.size());
+			openTiles.push_back(tile);
+		}
+	}
+
+	const int count = static_cast<int>(openTiles.size());
+	std::vector<std::vector<int>> moves(count);
+	for(int i = 0; i < count; ++i) {
+		graph.for_each_move(openTiles[i], [&](int target) {
+			if(openIndex[target] >= 0)
+				moves[i].push_back(openIndex[target]);
+		});
+	}
+
+	// Colour the tiles by walking the graph. A tile that cannot be reached means no tour.
+	// Knight's moves alternate colours on flat boards, but on a wrapped board with an odd side
+	// they do not, and then the colour clauses are left out.
+	std::vector<int> colours(count, -1);
+	bool twoColours = true;
+	std::vector<int> queue;
+	if(count > 0) {
+		colours[0] = 0;
+		queue.push_back(0);
+	}
+	for(size_t head = 0; head < queue.size(); ++head) {
+		for(int target : moves[queue[head]]) {
+			if(colours[target] < 0) {
+				colours[target] = colours[queue[head]] ^ 1;
+				queue.push_back(target);
+			}
+			else if(colours[target] == colours[queue[head]])
+				twoColours = false;
+		}
+	}
+
+	stats.status = SatStatus::Unsatisfiable;
+	if(count == 0 || static_cast<int>(queue.size()) < count)
+		return stats;
+	for(const auto& number : constraints.numbers) {
+		if(number.first < 0 || number.first >= tileCount || openIndex[number.first] < 0 || number.second < 1 || number.second > count)
+			return stats;
+	}
+
+	SatSolver solver;
+	for(int i = 0; i < count * count; ++i)
+		solver.add_variable();
+	auto visit = [count](int tile, int move) { return SatSolver::positive(tile * count + move); };
+	const int firstColour = solver.add_variable();
+	const bool closed = constraints.type == TourType::Closed;
+
+	std::vector<Literal> literals;
+	for(int move = 0; move < count; ++move) {
+		literals.clear();
+		for(int tile = 0; tile < count; ++tile)
+			literals.push_back(visit(tile, move));
+		solver.add_clause(literals);
+		add_at_most_one(solver, literals);
+	}
+	for(int tile = 0; tile < count; ++tile) {
+		literals.clear();
+		for(int move = 0; move < count; ++move)
+			literals.push_back(visit(tile, move));
+		solver.add_clause(literals);
+		add_at_most_one(solver, literals);
+	}
+
+	for(int tile = 0; tile < count; ++tile) {
+		for(int move = 0; move < count; ++move) {
+			Literal notHere = SatSolver::negate(visit(tile, move));
+			for(int step : { 1, -1 }) {
+				int neighbour = move + step;
+				if(neighbour < 0 || neighbour >= count) {
+					if(closed == false)
+						continue;
+					neighbour = (neighbour + count) % count;
+				}
+				literals.assign(1, notHere);
+				for(int target : moves[tile])
+					literals.push_back(visit(target, neighbour));
+				solver.add_clause(literals);
+			}
+
+			if(twoColours) {
+				bool oddColour = (colours[tile] ^ (move & 1)) != 0;
+				solver.add_clause({ notHere, oddColour ? SatSolver::positive(firstColour) : SatSolver::negative(firstColour) });
+			}
+		}
+	}
+
+	for(const auto& number : constraints.numbers)
+		solver.add_clause({ visit(openIndex[number.first], number.second - 1) });
+	if(closed && constraints.numbers.empty())
+		solver.add_clause({ visit(0, 0) });
+
+	stats.variables = solver.variable_count();
+	stats.clauses = solver.clause_count();
+	stats.status = solver.solve(constraints.maxConflicts);
+	stats.solver = solver.stats();
+	if(stats.status != SatStatus::Satisfiable)
+		return stats;
+
+	tour.resize(count);
+	for(int tile = 0; tile < count; ++tile) {
+		for(int move = 0; move < count; ++move) {
+			if(solver.value(tile * count + move))
+				tour[move] = static_cast<uint32_t>(openTiles[tile]);
+		}
+	}
+	return stats;
+}
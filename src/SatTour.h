@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Backtracking.h"
+#include "BoardGraph.h"
+#include "SatSolver.h"
+
+// Conditions on a tour for the SAT engine, on top of visiting every tile once.
+struct TourConstraints {
+	TourType type = TourType::Open;
+	std::vector<int> blocked;					// Tiles the tour must not enter.
+	std::vector<std::pair<int, int>> numbers;	// (tile, move) pairs, move 1 being the first tile.
+	uint64_t maxConflicts = 0;					// Give up after this many conflicts, 0 for no limit.
+};
+
+struct SatTourStats {
+	SatStatus status = SatStatus::Unknown;
+	int variables = 0;
+	size_t clauses = 0;
+	SatStats solver;
+};
+
+// Exact tour search as a constraint problem, the alternative to Backtracking for puzzles
+// where a search tree explodes: pre-placed move numbers, blocked tiles and closed tours on
+// boards too big to enumerate. Conflicts teach the solver which partial tours cannot be
+// finished, so it never meets the same dead end twice.
+//
+// Runs on the move graph of any board shape, and writes the tiles in move order to tour. The
+// tiles to visit are the open tiles of the graph that are not in constraints.blocked. The tour
+// is empty unless the status is Satisfiable. Unsatisfiable is a proof that no such tour exists.
+SatTourStats sat_tour(const BoardGraph& graph, const TourConstraints& constraints, std::vector<uint32_t>& tour);
+
+// Same on a board type from Board.h, like warnsdorff_tour.
+template <typename BoardType>
+SatTourStats sat_tour(const BoardType& board, const TourConstraints& constraints, std::vector<uint32_t>& tour) {
+	return sat_tour(BoardGraph::from_board(board), constraints, tour);
+}
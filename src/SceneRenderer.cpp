@@ -1,9 +1,65 @@
 #include "SceneRenderer.h"
 #include <DirectXColors.h>
+#include <chrono>
 
 
 using namespace DirectX;
 
+namespace {
+
+// Root parameters, in the order of BuildRootSignature.
+constexpr UINT boardConstantsParameter = 0;	// b0: view projection, then the tile size
+constexpr UINT textureParameter = 1;		// t0
+constexpr UINT instanceBufferParameter = 2;	// t1
+constexpr UINT tileSizeConstant = 16;		// after the 16 floats of the matrix
+
+// Past this many runs of recoloured tiles, one copy spanning all of them is cheaper.
+constexpr size_t maxUploadRuns = 64;
+
+// Conflicts the 'F' search may spend before giving up, a few seconds on 8x8.
+constexpr uint64_t finishTourConflicts = 50000;
+
+// Keys that change the board, ignored while the finish search has it.
+bool ChangesBoard(WPARAM button)
+{
+	return button == 0x43 || button == 0x55 || button == 0x52 || button == 0x53 || button == 0x46;
+}
+
+// Seconds on the performance counter, the clock DXGI frame statistics use.
+double QpcToSeconds(LONGLONG counter)
+{
+	static const double frequency = [] {
+		LARGE_INTEGER value;
+		QueryPerformanceFrequency(&value);
+		return static_cast<double>(value.QuadPart);
+	}();
+	return counter / frequency;
+}
+
+double Now()
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return QpcToSeconds(counter.QuadPart);
+}
+
+// The calls TileInstances::record_draw makes, on a D3D12 command list.
+struct BoardCommandList {
+	ID3D12GraphicsCommandList4* list;
+
+	void set_tile_size(float tileSize) {
+		list->SetGraphicsRoot32BitConstants(boardConstantsParameter, 1, &tileSize, tileSizeConstant);
+	}
+	void set_instance_buffer(D3D12_GPU_VIRTUAL_ADDRESS address) {
+		list->SetGraphicsRootShaderResourceView(instanceBufferParameter, address);
+	}
+	void draw_instanced(UINT indicesPerInstance, UINT instanceCount) {
+		list->DrawIndexedInstanced(indicesPerInstance, instanceCount, 0, 0, 0);
+	}
+};
+
+}
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,	PSTR cmdLine, int showCmd)
 {
 	// Enable run-time memory check for debug builds.
@@ -27,12 +83,15 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,	PSTR cmdLine, in
 }
 
 SceneRenderer::SceneRenderer(HINSTANCE hInstance)
-	: DXApp(hInstance)
+	: DXApp(hInstance), mTiles(mBoard.graph().rows(), mBoard.graph().columns())
 {
 }
 
 SceneRenderer::~SceneRenderer()
 {
+	// The gpu may still be reading the resources about to be released.
+	if (mDevice != nullptr)
+		FlushCommandQueue();
 }
 
 bool SceneRenderer::Initialize()
@@ -43,8 +102,10 @@ bool SceneRenderer::Initialize()
 	// Reset the command list to prep for initialization commands.
 	ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
 
+	mGraphicsMemory = std::make_unique<GraphicsMemory>(mDevice.Get());
+
 	BuildBuffers();
-	BuildConstantBuffer();
+	BuildFrameResources();
 	LoadTexture();
 	BuildDescriptorHeaps();
 	BuildRootSignature();
@@ -57,30 +118,36 @@ bool SceneRenderer::Initialize()
 	ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
 	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
+	// The upload buffers of the initialization commands have to outlive them.
+	FlushCommandQueue();
+
 	return true;
 }
 
 void SceneRenderer::OnResize()
 {
 	DXApp::OnResize();
+	BuildViewProjection();
 }
 
 void SceneRenderer::OnUpdate(const Timer& gt)
 {
-	
+	CheckFinishTour();
 }
 
 void SceneRenderer::OnMouseDown(WPARAM btnState, int x, int y)
 {
+	if (FinishTourRunning())
+		return;
+
 	int index = ScreenCoordToIndex(x, y);
-	if (KnightsTour::enforce_next_move(index)) {
-		KnightsTour::set_current_move_iterator(index);
-		KnightsTour::calculate_visitable_tile(KnightsTour::currentMoveItr);
-		KnightsTour::make_move(KnightsTour::currentMoveItr);
-		LoadTiles();
+	int previousTile = mBoard.current_tile();
+	if (mBoard.make_move(index)) {
+		mLatency.input(Now());
+		UpdateTilesAfterStep(previousTile);
 	}
 
-	if (KnightsTour::visitableTileExists == false) {
+	if (mBoard.visitable_tile_exists() == false) {
 		std::wstring controls = L"Nowhere to move from here.\n"
 			"Press U to undo your actions.\n"
 			"Press C to start over.";
@@ -89,38 +156,61 @@ void SceneRenderer::OnMouseDown(WPARAM btnState, int x, int y)
 }
 
 void SceneRenderer::OnKeyUp(WPARAM button) {
+	if (FinishTourRunning() && ChangesBoard(button))
+		return;
+
+	int previousTile = mBoard.current_tile();
 	switch (button)
 	{
 	case VK_ESCAPE:
 		PostQuitMessage(0);
 		break;
 	case 0x43: // 'C' button
-		KnightsTour::clear_screen();
+		mBoard.clear();
+		LoadTiles();
 		break;
 	case 0x55: // 'U' button
-		KnightsTour::undo_move();
+		mBoard.undo_move();
+		UpdateTilesAfterStep(previousTile);
 		break;
 	case 0x52: // 'R' button
-		KnightsTour::redo_move();
+		mBoard.redo_move();
+		UpdateTilesAfterStep(previousTile);
+		break;
+	case 0x53: // 'S' button
+		if (mBoard.is_first_move_made())
+			KnightsTour::solve_from(mBoard, mBoard.first_tile());
+		LoadTiles();
+		break;
+	case 0x46: // 'F' button
+		StartFinishTour();
+		break;
+	case 0x4D: // 'M' button
+		ShowUploadStatistics();
+		break;
+	case 0x50: // 'P' button
+		CyclePresentMode();
+		break;
+	case 0x4C: // 'L' button
+		ApplyPresentChange(mPresent.set_max_latency(mPresent.max_latency() % 3 + 1));
 		break;
 	default:
 		break;
 	}
-
-	if (KnightsTour::movesMade.empty() == false) {
-		if (KnightsTour::enforce_next_move(*KnightsTour::currentMoveItr)) {
-			KnightsTour::calculate_visitable_tile(KnightsTour::currentMoveItr);
-			KnightsTour::make_move(KnightsTour::currentMoveItr);
-		}
-	}
-
-	LoadTiles();
 }
 
 void SceneRenderer::Draw(const Timer& gt)
 {
-	ThrowIfFailed(mDirectCmdListAlloc->Reset());
-	ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), mPipelineStateObject.Get()));
+	// In waitable mode, start the frame only once the swap chain can take it, so input is
+	// read as late as possible. Then wait until the gpu is done with the oldest frame in
+	// flight and reuse its resources.
+	WaitForSwapChain();
+	mFrames->begin_frame();
+	const int frame = mFrames->frame_index();
+	ThrowIfFailed(mFrameAllocators[frame]->Reset());
+	ThrowIfFailed(mCommandList->Reset(mFrameAllocators[frame].Get(), mPipelineStateObject.Get()));
+
+	UploadDirtyTiles();
 
 	// populate the command list
 	{
@@ -146,13 +236,12 @@ void SceneRenderer::Draw(const Timer& gt)
 		mCommandList->SetDescriptorHeaps(_countof(srvDescriptorHeaps), srvDescriptorHeaps);
 
 		CD3DX12_GPU_DESCRIPTOR_HANDLE tex(mSrvHeap->GetGPUDescriptorHandleForHeapStart());
-		mCommandList->SetGraphicsRootDescriptorTable(1, tex);
+		mCommandList->SetGraphicsRootDescriptorTable(textureParameter, tex);
 
-// 			LoadTilePositions(tile);
-		for(int tile = 0; tile < KnightsTour::chessboard.size(); ++tile) {
-			mCommandList->SetGraphicsRootConstantBufferView(0, mConstantBuffer->GetGPUVirtualAddress() + (sizeof(mConstantBufferData) * tile));
-			mCommandList->DrawIndexedInstanced(6, 1, 0, 0, 0);
-		}
+		// the whole board is one instanced draw, however many tiles it has
+		mCommandList->SetGraphicsRoot32BitConstants(boardConstantsParameter, 16, &mViewProjection, 0);
+		BoardCommandList boardCommands{ mCommandList.Get() };
+		mTiles.record_draw(boardCommands, mInstanceBuffer->GetGPUVirtualAddress());
 
 		mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
 			D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
@@ -166,24 +255,27 @@ void SceneRenderer::Draw(const Timer& gt)
 	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
 	// swap the back and front buffers
-	ThrowIfFailed(mSwapChain->Present(0, 0));
-	mCurrBackBuffer = (mCurrBackBuffer + 1) % SwapChainBufferCount;
+	PresentFrame();
+	TrackDisplayedFrames();
 
-	// Wait until frame commands are complete.  This waiting is inefficient and is done for simplicity. 
-	FlushCommandQueue();
+	// Mark the frame's resources busy until the gpu gets here, and move on without waiting.
+	mFrames->end_frame();
+
+	// Hand this frame's upload pages back to the ring once the gpu is past them.
+	mGraphicsMemory->Commit(mCommandQueue.Get());
 }
 
 void SceneRenderer::BuildRootSignature()
 {
-	CD3DX12_ROOT_PARAMETER1 rootParameters[2] = {};
-	CD3DX12_DESCRIPTOR_RANGE1 cbvTable = {}; 
+	CD3DX12_ROOT_PARAMETER1 rootParameters[3] = {};
 	CD3DX12_DESCRIPTOR_RANGE1 srvTable = {}; 
 
-	cbvTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC);
 	srvTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC);
 
-	rootParameters[0].InitAsConstantBufferView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE,  D3D12_SHADER_VISIBILITY_ALL);
-	rootParameters[1].InitAsDescriptorTable(1, &srvTable, D3D12_SHADER_VISIBILITY_PIXEL);	
+	// view projection and tile size as root constants, tile instances as a root srv
+	rootParameters[boardConstantsParameter].InitAsConstants(tileSizeConstant + 1, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	rootParameters[textureParameter].InitAsDescriptorTable(1, &srvTable, D3D12_SHADER_VISIBILITY_PIXEL);	
+	rootParameters[instanceBufferParameter].InitAsShaderResourceView(1, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE, D3D12_SHADER_VISIBILITY_VERTEX);
 
 	// sampler for texture
 	const CD3DX12_STATIC_SAMPLER_DESC pointClamp(
@@ -228,12 +320,13 @@ void SceneRenderer::BuildBuffers()
 		XMFLOAT2 texCoord;
 	};
 
+	// unit quad, scaled to the tile size by the vertex shader
 	Vertex vertices[] = {
 		// positions				// texCoords
-		{ { -0.125f, -0.125f , 0.0f}, { 0.0f, 1.0f } },
-		{ {  0.125f, -0.125f , 0.0f}, { 1.0f, 1.0f } },
-		{ { -0.125f,  0.125f , 0.0f}, { 0.0f, 0.0f } },
-		{ {  0.125f,  0.125f , 0.0f}, { 1.0f, 0.0f } }
+		{ { -0.5f, -0.5f , 0.0f}, { 0.0f, 1.0f } },
+		{ {  0.5f, -0.5f , 0.0f}, { 1.0f, 1.0f } },
+		{ { -0.5f,  0.5f , 0.0f}, { 0.0f, 0.0f } },
+		{ {  0.5f,  0.5f , 0.0f}, { 1.0f, 0.0f } }
 	};
 
 	// set indices
@@ -270,29 +363,50 @@ void SceneRenderer::BuildBuffers()
 	mIndexBufferView.SizeInBytes = ibByteSize;
 }
 
-void SceneRenderer::BuildConstantBuffer()
+void SceneRenderer::BuildFrameResources()
 {
-	// describe constant buffer heap
+	for (auto& allocator : mFrameAllocators)
+		ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(allocator.GetAddressOf())));
 
-	const UINT	constantBufferSize = sizeof(TileConstantBuffer);
-	
-	// create constant buffer
-	ThrowIfFailed(mDevice->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(1024 * 64),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&mConstantBuffer)));
-
-	ZeroMemory(&mConstantBufferData, sizeof(mConstantBufferData));
-
-	// map and initialize constant buffer. don't unmap until the app closes.
-	CD3DX12_RANGE readRange(0, 0); // we don't intend to read from this resource on the CPU.
-	ThrowIfFailed(mConstantBuffer->Map(0, &readRange, reinterpret_cast<void**>(&mCbvDataBegin)));
-	for(int i = 0; i < KnightsTour::chessboard.size(); ++i) {
-		memcpy(mCbvDataBegin + (sizeof(mConstantBufferData) * i), &mConstantBufferData, sizeof(mConstantBufferData));
+	// create instance buffer, one TileInstance per tile. it only needs the upload buffer
+	// until the initialization commands have run.
+	mInstanceBuffer = DXUtil::CreateDefaultBuffer(mDevice.Get(),
+		mCommandList.Get(), mTiles.data(), mTiles.byte_size(), mInstanceBufferUploader);
+}
+
+// Records copies of the tiles recoloured since the last frame into the instance buffer, from
+// upload memory of the ring. Copies run in queue order, after the draws of earlier frames have
+// read the old colours, so one instance buffer serves every frame in flight.
+void SceneRenderer::UploadDirtyTiles()
+{
+	if (mTiles.dirty_count() == 0)
+		return;
+
+	std::vector<TileRun> runs = mTiles.take_dirty_runs();
+	if (runs.size() > maxUploadRuns)
+		runs = { { runs.front().first, runs.back().first + runs.back().count - runs.front().first } };
+
+	size_t tileCount = 0;
+	for (const TileRun& run : runs)
+		tileCount += run.count;
+	GraphicsResource upload = mGraphicsMemory->Allocate(tileCount * sizeof(TileInstance));
+
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mInstanceBuffer.Get(),
+		D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_COPY_DEST));
+
+	size_t uploadOffset = 0;
+	for (const TileRun& run : runs) {
+		const size_t bytes = run.count * sizeof(TileInstance);
+		memcpy(static_cast<UINT8*>(upload.Memory()) + uploadOffset, mTiles.data() + run.first, bytes);
+		mCommandList->CopyBufferRegion(mInstanceBuffer.Get(), run.first * sizeof(TileInstance),
+			upload.Resource(), upload.ResourceOffset() + uploadOffset, bytes);
+		uploadOffset += bytes;
 	}
+
+	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mInstanceBuffer.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+
+	// upload goes back to the ring here, which keeps its page until the frame is committed and done
 }
 
 void SceneRenderer::BuildDescriptorHeaps()
@@ -347,13 +461,102 @@ void SceneRenderer::ShowControls()
 	std::wstring controls = L"Controls:\n"
 		"Press U to undo move\n"
 		"Press R to redo move\n"
-		"Press C to clear screen\n";
+		"Press C to clear screen\n"
+		"Press S to solve from the first move\n"
+		"Press F to finish the tour from here\n"
+		"Press M to show upload memory use\n"
+		"Press P to switch present mode (vsync, uncapped, tearing, waitable)\n"
+		"Press L to change the maximum frame latency of waitable mode\n";
 	MessageBox(nullptr, controls.c_str(), L"Controls", MB_OK);
 }
 
-void SceneRenderer::LoadTiles()
+// Runs the SAT search on a copy of the board on another thread, so a hard position does not
+// stall the window. The board only changes once the search is back, in CheckFinishTour.
+void SceneRenderer::StartFinishTour()
+{
+	mFinishSearch = std::async(std::launch::async, [board = mBoard]() mutable {
+		SatStatus status = KnightsTour::complete_tour(board, TourType::Open, finishTourConflicts);
+		return std::make_pair(status, std::move(board));
+	});
+}
+
+bool SceneRenderer::FinishTourRunning() const
+{
+	return mFinishSearch.valid();
+}
+
+void SceneRenderer::CheckFinishTour()
+{
+	if (mFinishSearch.valid() == false || mFinishSearch.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+
+	std::pair<SatStatus, BoardState> result = mFinishSearch.get();
+	switch (result.first)
+	{
+	case SatStatus::Satisfiable:
+		mBoard = std::move(result.second);
+		LoadTiles();
+		break;
+	case SatStatus::Unsatisfiable:
+		MessageBox(nullptr, L"No tour continues from here.", L"Finish tour", MB_OK);
+		break;
+	default:
+		MessageBox(nullptr, (L"Gave up after " + std::to_wstring(finishTourConflicts) + L" conflicts without finding a tour.\n"
+			"A tour may still continue from here.").c_str(), L"Finish tour", MB_OK);
+		break;
+	}
+}
+
+void SceneRenderer::CyclePresentMode()
+{
+	SwapChainChange change = mPresent.next_mode();
+	if (change == SwapChainChange::Recreate)
+		mLatency.drop_pending();	// the new swap chain counts presents from zero
+	ApplyPresentChange(change);
+}
+
+// Matches the present that just happened to the clicks before it, and the present the display
+// reports on screen to its clicks. Clicks on presents that were never reported go unmeasured.
+// Frame statistics are not available in every windowed configuration, then no latency is
+// measured.
+void SceneRenderer::TrackDisplayedFrames()
+{
+	UINT presentCount = 0;
+	if (SUCCEEDED(mSwapChain->GetLastPresentCount(&presentCount)))
+		mLatency.presented(presentCount, mPresent.mode());
+
+	DXGI_FRAME_STATISTICS stats = {};
+	if (SUCCEEDED(mSwapChain->GetFrameStatistics(&stats)))
+		mLatency.displayed(stats.PresentCount, QpcToSeconds(stats.SyncQPCTime.QuadPart));
+}
+
+std::wstring SceneRenderer::CaptionStats() const
+{
+	std::string mode = present_mode_name(mPresent.mode());
+	std::wstring text = FinishTourRunning() ? L"   finishing tour..." : L"";
+	text += L"   present: " + std::wstring(mode.begin(), mode.end());
+	if (mPresent.waitable())
+		text += L" (max latency " + std::to_wstring(mPresent.max_latency()) + L")";
+
+	const LatencyTracker::Stats& latency = mLatency.stats(mPresent.mode());
+	if (latency.samples != 0)
+		text += L"   click to photon: " + std::to_wstring(latency.last * 1000.0) + L" ms, mean " + std::to_wstring(latency.mean() * 1000.0) + L" ms";
+	return text;
+}
+
+// High-water marks of the upload ring since start-up, in bytes and pages.
+void SceneRenderer::ShowUploadStatistics()
 {
+	GraphicsMemoryStatistics stats = mGraphicsMemory->GetStatistics();
+	std::wstring text = L"In flight: " + std::to_wstring(stats.committedMemory) + L" bytes\n"
+		L"Allocated: " + std::to_wstring(stats.totalMemory) + L" bytes in " + std::to_wstring(stats.totalPages) + L" pages\n"
+		L"Peak in flight: " + std::to_wstring(stats.peakCommitedMemory) + L" bytes\n"
+		L"Peak allocated: " + std::to_wstring(stats.peakTotalMemory) + L" bytes in " + std::to_wstring(stats.peakTotalPages) + L" pages\n";
+	MessageBox(nullptr, text.c_str(), L"Upload memory", MB_OK);
+}
 
+void SceneRenderer::BuildViewProjection()
+{
 	// build projection matrix
 	XMMATRIX tmpMat = XMMatrixOrthographicLH(2, 2, 0.0f, 1.0f);
 	XMStoreFloat4x4(&projectionMatrix, tmpMat);
@@ -369,35 +572,47 @@ void SceneRenderer::LoadTiles()
 	tmpMat = XMMatrixLookAtLH(cPos, cTarg, cUp);
 	XMStoreFloat4x4(&viewMatrix, tmpMat);
 
-	int bufferOffset = 0;
-	DirectX::XMFLOAT4 positionOffset { -0.875, 0.875, 0, 0 };
-	for(int row = rows - 1; row >= 0; --row) {
-		for(uint8_t column = 0; column < columns; ++column) {
-			Tile& tile = KnightsTour::chessboard.at(((rows * row) + column));
-			tile.position.x = positionOffset.x;
-			tile.position.y = positionOffset.y;
-			tile.position.z = positionOffset.z;
-			
-			XMVECTOR posVec = XMLoadFloat4(&tile.position); // create xmvector for tile position
-			tmpMat = XMMatrixTranslationFromVector(posVec); // create translation matrix from cube1's position vector
-			XMStoreFloat4x4(&tile.worldMatrix, XMMatrixIdentity()); // initialize cube1's rotation matrix to identity matrix
-			XMStoreFloat4x4(&tile.worldMatrix, XMMatrixTranspose(tmpMat)); // store cube1's world matrix
-
-			XMMATRIX viewMat = XMLoadFloat4x4(&viewMatrix); // load view matrix
-			XMMATRIX projMat = XMLoadFloat4x4(&projectionMatrix); // load projection matrix
-			XMMATRIX wvpMat = XMLoadFloat4x4(&tile.worldMatrix) * viewMat * projMat; // create wvp matrix
-			XMMATRIX transposed = XMMatrixTranspose(wvpMat);
-			XMStoreFloat4x4(&mConstantBufferData.mvp, wvpMat);
-			mConstantBufferData.color = tile.color;
-			
-			memcpy(mCbvDataBegin + (sizeof(mConstantBufferData) * bufferOffset), &mConstantBufferData, sizeof(mConstantBufferData));
-
-			positionOffset.x += 0.25f;
-			++bufferOffset;
-		}
-		positionOffset.y -= 0.25f;
-		positionOffset.x = -0.875f;
-	}
+	XMMATRIX viewProjection = XMLoadFloat4x4(&viewMatrix) * XMLoadFloat4x4(&projectionMatrix);
+	XMStoreFloat4x4(&mViewProjection, XMMatrixTranspose(viewProjection));
+}
+
+// Recolours the whole board, for changes that can touch any tile (clear, solve). Draw writes
+// only the tiles whose colour actually changed to the instance buffer.
+void SceneRenderer::LoadTiles()
+{
+	for(int tile = 0; tile < mTiles.count(); ++tile)
+		mTiles.set_color(tile, TileColor(tile));
+}
+
+// A single move, undo or redo only changes the colours of the tile the knight left, the tile it
+// is on now and the tiles a knight's move from either.
+void SceneRenderer::UpdateTilesAfterStep(int previousTile)
+{
+	RecolorNeighbourhood(previousTile);
+	RecolorNeighbourhood(mBoard.current_tile());
+}
+
+void SceneRenderer::RecolorNeighbourhood(int tile)
+{
+	if (tile < 0)
+		return;
+
+	mTiles.set_color(tile, TileColor(tile));
+	mBoard.graph().for_each_move(tile, [&](int target) { mTiles.set_color(target, TileColor(target)); });
+}
+
+uint32_t SceneRenderer::TileColor(int tile) const
+{
+	if (mBoard.is_open(tile) == false)
+		return pack_rgba8(0.0f, 0.0f, 0.0f, 1.0f);	// blocked
+	if (tile == mBoard.current_tile())
+		return pack_rgba8(0.5f, 1.0f, 0.5f, 0.0f);	// knight is standing here
+	if (mBoard.is_visitable(tile))
+		return pack_rgba8(0.3f, 0.3f, 0.7f, 0.5f);
+	if (mBoard.is_visited(tile))
+		return pack_rgba8(0.3f, 0.3f, 0.3f, 1.0f);
+
+	return pack_rgba8(1.0f, 1.0f, 1.0f, 1.0f);
 }
 
 int SceneRenderer::ScreenCoordToIndex(int x, int y)
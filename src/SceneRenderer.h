@@ -1,15 +1,13 @@
 #pragma once
+#include <future>
+#include <utility>
+
 #include "DXApp.h"
 #include "KnightsTour.h"
+#include "TileInstances.h"
 
 using Microsoft::WRL::ComPtr;
 
-struct TileConstantBuffer {
-	DirectX::XMFLOAT4X4 mvp;
-	DirectX::XMFLOAT4 color;
-	float padding[44]; // constant buffer size must be multiple of 256byte
-};
-
 struct Texture
 {
 	// Unique material name for lookup.
@@ -34,6 +32,7 @@ private:
 	void OnUpdate(const Timer& gt) override;
 	void OnMouseDown(WPARAM btnState, int x, int y) override;
 	void OnKeyUp(WPARAM button) override;
+	std::wstring CaptionStats() const override;
 
 
 	void Draw(const Timer& gt) override;
@@ -41,20 +40,46 @@ private:
 	void BuildRootSignature();
 	void BuildShadersAndInputLayout();
 	void BuildBuffers();
-	void BuildConstantBuffer();
+	void BuildFrameResources();
+	void UploadDirtyTiles();
 	void BuildDescriptorHeaps();
 	void LoadTexture();
 	void UpdateMVP();
+	void BuildViewProjection();
 
 	void ShowControls();
+	void ShowUploadStatistics();
+	void CyclePresentMode();
+	void StartFinishTour();
+	void CheckFinishTour();
+	bool FinishTourRunning() const;
+	void TrackDisplayedFrames();
 	void LoadTiles();
+	void UpdateTilesAfterStep(int previousTile);
+	void RecolorNeighbourhood(int tile);
+	uint32_t TileColor(int tile) const;
 	int ScreenCoordToIndex(int x, int y);
+
+	// click to photon latency of moves, per present mode
+	LatencyTracker mLatency;
+
+	// game state and tiles
+	BoardState mBoard;
+	TileInstances mTiles;
+
+	// the 'F' search, on a copy of mBoard. input that changes the board waits for it
+	std::future<std::pair<SatStatus, BoardState>> mFinishSearch;
 	
-	// constant buffer
-	ComPtr<ID3D12DescriptorHeap> mCbvHeap;
-	ComPtr<ID3D12Resource> mConstantBuffer;
-	UINT8* mCbvDataBegin = nullptr;
-	TileConstantBuffer mConstantBufferData{};
+	// per tile instance data, read by the vertex shader through SV_InstanceID. lives in a
+	// default heap, recoloured tiles are copied in from upload memory at the start of a frame.
+	ComPtr<ID3D12Resource> mInstanceBuffer;
+	ComPtr<ID3D12Resource> mInstanceBufferUploader;
+
+	// ring of upload pages for per frame data, retired by fence once the gpu is done with them
+	std::unique_ptr<DirectX::GraphicsMemory> mGraphicsMemory;
+
+	// command allocator per frame in flight
+	std::array<ComPtr<ID3D12CommandAllocator>, FrameResourceCount> mFrameAllocators;
 
 	// dx necessary state
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mInputLayout;
@@ -79,5 +104,6 @@ private:
 
 	DirectX::XMFLOAT4X4 projectionMatrix; // this will store our projection matrix
 	DirectX::XMFLOAT4X4 viewMatrix; // this will store our view matrix
+	DirectX::XMFLOAT4X4 mViewProjection; // transposed view * projection for the shader
 
 };
\ No newline at end of file
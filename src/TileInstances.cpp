@@ -0,0 +1,45 @@
+#include "TileInstances.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+TileInstances::TileInstances(int rows, int columns) : rowCount(rows), columnCount(columns) {
+	if(rows < 1 || columns < 1)
+		throw std::invalid_argument("A board needs at least one row and one column.");
+
+	// Square tiles, as big as the longer side allows, with the board centred.
+	tileSize = 2.0f / std::max(rows, columns);
+	const float left = -0.5f * tileSize * (columns - 1);
+	const float bottom = -0.5f * tileSize * (rows - 1);
+
+	instances.resize(static_cast<size_t>(rows) * columns);
+	dirty.assign(instances.size(), 0);
+	for(int row = 0; row < rows; ++row) {
+		for(int column = 0; column < columns; ++column) {
+			TileInstance& instance = instances[static_cast<size_t>(columns) * row + column];
+			instance.x = left + tileSize * column;
+			instance.y = bottom + tileSize * row;
+			instance.color = pack_rgba8(1.0f, 1.0f, 1.0f, 1.0f);
+		}
+	}
+}
+
+const std::vector<TileRun>& TileInstances::take_dirty_runs() {
+	runs.clear();
+	if(dirtyTiles.size() * 4 > instances.size())
+		runs.push_back({ 0, count() });
+	else {
+		std::sort(dirtyTiles.begin(), dirtyTiles.end());
+		for(int tile : dirtyTiles) {
+			if(runs.empty() == false && runs.back().first + runs.back().count == tile)
+				++runs.back().count;
+			else
+				runs.push_back({ tile, 1 });
+		}
+	}
+
+	for(int tile : dirtyTiles)
+		dirty[tile] = 0;
+	dirtyTiles.clear();
+	return runs;
+}
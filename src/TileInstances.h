@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Packs a colour with components from 0 to 1 into R8G8B8A8_UNORM order, red in the low byte,
+// the way the shader unpacks it.
+constexpr uint32_t pack_rgba8(float red, float green, float blue, float alpha) {
+	auto channel = [](float value) {
+		value = value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value;
+		return static_cast<uint32_t>(value * 255.0f + 0.5f);
+	};
+	return channel(red) | channel(green) << 8 | channel(blue) << 16 | channel(alpha) << 24;
+}
+
+// What the shader reads per tile from its structured buffer, through SV_InstanceID. Has to
+// match TileInstance in Shaders/Shader.hlsl.
+struct TileInstance {
+	float x;		// Centre of the tile in board space, where the board fills -1 to 1.
+	float y;
+	uint32_t color;	// pack_rgba8
+};
+static_assert(sizeof(TileInstance) == 12, "The structured buffer stride in Shader.hlsl is 12 bytes.");
+
+// Consecutive tiles, count of them starting at first.
+struct TileRun {
+	int first;
+	int count;
+};
+
+// Instance data for every tile of a rows x columns board, indexed like the tiles of
+// BoardState. The whole board is one instanced draw of a unit quad, scaled by tile_size() and
+// moved to each instance, so the number of draw calls does not grow with the board.
+//
+// Positions are fixed when the board is laid out. Colours that change are remembered until
+// take_dirty_runs hands them out as runs of tiles to copy to the GPU, so a move costs the
+// handful of tiles it recoloured and not the whole board.
+class TileInstances {
+public:
+	TileInstances(int rows, int columns);
+
+	int rows() const { return rowCount; }
+	int columns() const { return columnCount; }
+	int count() const { return static_cast<int>(instances.size()); }
+	float tile_size() const { return tileSize; }	// Side of a tile in board space.
+
+	const TileInstance& operator[](int tile) const { return instances[tile]; }
+	void set_color(int tile, uint32_t color) {
+		if(instances[tile].color == color)
+			return;
+		instances[tile].color = color;
+		if(dirty[tile] == 0) {
+			dirty[tile] = 1;
+			dirtyTiles.push_back(tile);
+		}
+	}
+	int dirty_count() const { return static_cast<int>(dirtyTiles.size()); }	// Tiles recoloured since the last take_dirty_runs.
+
+	const TileInstance* data() const { return instances.data(); }
+	size_t byte_size() const { return instances.size() * sizeof(TileInstance); }
+
+	// The runs of tiles to copy from data() to the GPU, in tile order, covering every tile
+	// recoloured since the last call, and marks them clean. Past a quarter of the board it is
+	// one run of all of it, since one straight copy beats scattered ones.
+	const std::vector<TileRun>& take_dirty_runs();
+
+	// Records the board into a command list with set_tile_size(float),
+	// set_instance_buffer(address) and draw_instanced(indicesPerInstance, instanceCount):
+	// three calls whatever the size of the board. The D3D12 renderer and anything counting
+	// calls without a GPU implement the same three.
+	template <typename CommandList, typename Address>
+	void record_draw(CommandList& list, Address instanceBuffer) const {
+		list.set_tile_size(tileSize);
+		list.set_instance_buffer(instanceBuffer);
+		list.draw_instanced(indicesPerTile, static_cast<uint32_t>(instances.size()));
+	}
+
+	static constexpr uint32_t indicesPerTile = 6;	// Two triangles.
+
+private:
+	int rowCount;
+	int columnCount;
+	float tileSize;
+	std::vector<TileInstance> instances;
+	std::vector<uint8_t> dirty;		// Non-zero for the tiles in dirtyTiles.
+	std::vector<int> dirtyTiles;
+	std::vector<TileRun> runs;
+};
@@ -0,0 +1,115 @@
+#include "TourFile.h"
+
+#include <cstring>
+
+
+namespace {
+
+constexpr char tourFileMagic[4] = { 'K', 'T', 'R', 'F' };
+constexpr uint16_t tourFileVersion = 1;
+
+}
+
+TourFileWriter::TourFileWriter(const std::string& path, int rows, int columns)
+	: buffer(1 << 16), offset(sizeof(TourFileHeader)), rowCount(rows), columnCount(columns) {
+	if(rows < 1 || columns < 1 || rows > maxDimension || columns > maxDimension)
+		throw std::invalid_argument("Tour files hold boards between 1x1 and " + std::to_string(maxDimension) + "x" + std::to_string(maxDimension) + ".");
+
+	out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	out.open(path, std::ios::binary | std::ios::trunc);
+	if(out.is_open() == false)
+		throw std::runtime_error("Could not open " + path + " for writing.");
+
+	// Placeholder until close() knows the tour count and where the index starts.
+	TourFileHeader header{};
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+TourFileWriter::~TourFileWriter() {
+	try {
+		close();
+	}
+	catch(...) {
+	}
+}
+
+void TourFileWriter::close() {
+	if(closed)
+		return;
+	closed = true;
+
+	// Pad so the index can be read in place as 64 bit words.
+	const char padding[8] = {};
+	uint64_t indexOffset = (offset + 7) & ~uint64_t(7);
+	out.write(padding, static_cast<std::streamsize>(indexOffset - offset));
+	out.write(reinterpret_cast<const char*>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+
+	TourFileHeader header{};
+	std::memcpy(header.magic, tourFileMagic, sizeof(header.magic));
+	header.version = tourFileVersion;
+	header.rows = static_cast<uint8_t>(rowCount);
+	header.columns = static_cast<uint8_t>(columnCount);
+	header.tourCount = offsets.size();
+	header.indexOffset = indexOffset;
+	out.seekp(0);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.close();
+
+	if(out.fail())
+		throw std::runtime_error("Writing the tour file failed.");
+}
+
+uint8_t TourFileWriter::direction(int from, int to) const {
+	int rowDelta = to / columnCount - from / columnCount;
+	int columnDelta = to % columnCount - from % columnCount;
+	for(uint8_t i = 0; i < 8; ++i) {
+		if(knightRowOffsets[i] == rowDelta && knightColumnOffsets[i] == columnDelta)
+			return i;
+	}
+	throw std::invalid_argument("Consecutive tour tiles must be a knight's move apart.");
+}
+
+TourFileReader::TourFileReader(const std::string& path) : file(path) {
+	data = file.data();
+	size_t fileSize = file.size();
+
+	std::string error;
+	if(fileSize < sizeof(TourFileHeader))
+		error = path + " is not a tour file.";
+	else {
+		std::memcpy(&header, data, sizeof(header));
+		if(std::memcmp(header.magic, tourFileMagic, sizeof(header.magic)) != 0 || header.version != tourFileVersion)
+			error = path + " is not a tour file.";
+		else if(header.indexOffset == 0)
+			error = path + " was not closed properly.";
+		else if(header.rows < 1 || header.columns < 1 || header.rows > TourFileWriter::maxDimension || header.columns > TourFileWriter::maxDimension)
+			error = path + " has a broken header.";
+		else if(header.indexOffset < sizeof(TourFileHeader) || header.indexOffset % sizeof(uint64_t) != 0 ||
+			header.indexOffset > fileSize || (fileSize - header.indexOffset) / sizeof(uint64_t) < header.tourCount)
+			error = path + " has a broken header.";
+	}
+
+	if(error.empty()) {
+		index = reinterpret_cast<const uint64_t*>(data + header.indexOffset);
+		// Every record, its length byte, start tile and moves, has to end before the index.
+		for(uint64_t i = 0; i < header.tourCount; ++i) {
+			if(index[i] < sizeof(TourFileHeader) || index[i] >= header.indexOffset || index[i] + data[index[i]] + 2 > header.indexOffset) {
+				error = path + " has a broken index.";
+				break;
+			}
+		}
+	}
+
+	if(error.empty() == false)
+		throw std::runtime_error(error);
+}
+
+bool TourFileReader::is_tour_file(const uint8_t* data, size_t size) {
+	return size >= sizeof(TourFileHeader) && std::memcmp(data, tourFileMagic, sizeof(tourFileMagic)) == 0;
+}
+
+int TourFileReader::tour(uint64_t number, std::vector<int>& tiles) const {
+	tiles.clear();
+	for_each_tile(number, [&](int index) { tiles.push_back(index); });
+	return static_cast<int>(tiles.size());
+}
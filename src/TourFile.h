@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "MappedFile.h"
+
+// Compact binary file of many tours on one board, for boards up to 16x16.
+//
+// Layout, all integers little endian:
+//  - TourFileHeader (24 bytes),
+//  - one record per tour: a byte holding the tour length - 1, a byte holding the start
+//    tile, then one byte per move with the jump direction from the previous tile (an index
+//    into knightRowOffsets / knightColumnOffsets),
+//  - zero padding to a multiple of 8 bytes,
+//  - the index: tourCount 64 bit file offsets, one per record, starting at indexOffset.
+//
+// A full 8x8 tour takes 65 bytes against about 200 bytes as chess notation.
+struct TourFileHeader {
+	char magic[4];			// "KTRF"
+	uint16_t version;
+	uint8_t rows;
+	uint8_t columns;
+	uint64_t tourCount;
+	uint64_t indexOffset;	// Zero while the file is still being written.
+};
+
+static_assert(sizeof(TourFileHeader) == 24, "Tour file header must be packed.");
+
+// Streams tours to a file. The index is kept in memory and appended by close(), which
+// also fills in the header, so a file that was not closed has indexOffset zero.
+class TourFileWriter {
+public:
+	static constexpr int maxDimension = 16;
+
+	TourFileWriter(const std::string& path, int rows, int columns);
+	~TourFileWriter();
+
+	TourFileWriter(const TourFileWriter&) = delete;
+	TourFileWriter& operator=(const TourFileWriter&) = delete;
+
+	// Appends the first length tiles of tiles. Consecutive tiles must be a knight's move
+	// apart.
+	template <typename TileIndex>
+	void add(const TileIndex* tiles, int length) {
+		if(length < 1 || length > rowCount * columnCount)
+			throw std::invalid_argument("Tour length must be between 1 and the number of tiles.");
+
+		record.resize(static_cast<size_t>(length) + 1);
+		record[0] = static_cast<uint8_t>(length - 1);
+		record[1] = static_cast<uint8_t>(tiles[0]);
+		for(int i = 1; i < length; ++i)
+			record[i + 1] = direction(static_cast<int>(tiles[i - 1]), static_cast<int>(tiles[i]));
+
+		offsets.push_back(offset);
+		out.write(reinterpret_cast<const char*>(record.data()), static_cast<std::streamsize>(record.size()));
+		offset += record.size();
+	}
+
+	uint64_t tour_count() const { return offsets.size(); }
+
+	void close();
+
+private:
+	uint8_t direction(int from, int to) const;
+
+	std::ofstream out;
+	std::vector<char> buffer;
+	std::vector<uint8_t> record;
+	std::vector<uint64_t> offsets;
+	uint64_t offset;
+	int rowCount;
+	int columnCount;
+	bool closed = false;
+};
+
+// Read only memory mapping of a tour file. Tours are decoded on demand, so opening a file
+// with millions of tours costs nothing until they are read.
+class TourFileReader {
+public:
+	explicit TourFileReader(const std::string& path);
+
+	// Whether data starts like a tour file.
+	static bool is_tour_file(const uint8_t* data, size_t size);
+
+	int rows() const { return header.rows; }
+	int columns() const { return header.columns; }
+	// Tours are numbered 0 to size() - 1 in the order they were written. The constructor
+	// checks the header, the index and that every record ends before the index, but not the
+	// moves in the records. Numbers are not range checked.
+	uint64_t size() const { return header.tourCount; }
+
+	// Number of tiles in tour number.
+	int length(uint64_t number) const { return static_cast<int>(record(number)[0]) + 1; }
+
+	// Calls f(index) for every tile of tour number in order.
+	template <typename Function>
+	void for_each_tile(uint64_t number, Function&& f) const {
+		for_each_position(number, [&](int row, int column) { f(header.columns * row + column); });
+	}
+
+	// Calls f(row, column) for every tile of tour number in order. A corrupt record can walk
+	// off the board, which shows up here as rows or columns out of range.
+	template <typename Function>
+	void for_each_position(uint64_t number, Function&& f) const {
+		const uint8_t* data = record(number);
+		int length = static_cast<int>(data[0]) + 1;
+		int row = data[1] / header.columns;
+		int column = data[1] % header.columns;
+		f(row, column);
+		for(int i = 1; i < length; ++i) {
+			uint8_t direction = data[i + 1] & 7;
+			row += knightRowOffsets[direction];
+			column += knightColumnOffsets[direction];
+			f(row, column);
+		}
+	}
+
+	// Decodes tour number into tiles and returns its length.
+	int tour(uint64_t number, std::vector<int>& tiles) const;
+
+private:
+	const uint8_t* record(uint64_t number) const { return data + index[number]; }
+
+	MappedFile file;
+	TourFileHeader header;
+	const uint8_t* data = nullptr;
+	const uint64_t* index = nullptr;
+};
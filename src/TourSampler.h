@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "BatchWalker.h"
+#include "Bitboard.h"
+#include "Random.h"
+
+struct SamplerOptions {
+	int threads = 0;	// Worker threads, 0 uses every hardware thread.
+	uint64_t seed = 0;
+	BatchPolicy policy = BatchPolicy::Uniform;
+};
+
+template <int TileCount>
+struct SampleStats {
+	uint64_t samples = 0;
+	uint64_t fullTours = 0;
+	uint64_t closedTours = 0;
+	std::array<uint64_t, TileCount> endSquares{};		// Where each walk stopped.
+	std::array<uint64_t, TileCount + 1> lengths{};		// Tiles visited per walk, so a dead end at depth d counts in lengths[d].
+
+	// Knuth's estimate of the number of tours from the start: the mean over uniform walks of
+	// the product of the choices along the way, counting only walks that became tours.
+	// Zero for other policies, which have no such unbiased estimate.
+	double estimatedTours = 0.0;
+
+	void merge(const SampleStats& other) {
+		samples += other.samples;
+		fullTours += other.fullTours;
+		closedTours += other.closedTours;
+		for(int i = 0; i < TileCount; ++i)
+			endSquares[i] += other.endSquares[i];
+		for(int i = 0; i <= TileCount; ++i)
+			lengths[i] += other.lengths[i];
+	}
+};
+
+// Random knight walks from a start tile, spread over threads, collecting statistics instead of
+// the walks themselves.
+//
+// Uniform walks pick every move uniformly, which does not make the tours they complete uniform:
+// a tour with fewer choices along the way is drawn more often. sample() only reports walk
+// statistics. sample_tours() returns the completed tours with their importance weight, one over
+// the probability of drawing them, and weighting by it gives averages over uniform tours
+// (every tour for the uniform policy, the tours Warnsdorff ties can reach otherwise).
+//
+// Sample i always draws from stream i of the seed (SplitMix64::split), whichever thread runs
+// it, and the statistics are sums merged after the threads finish, so results are bit for bit
+// the same for any thread count. Each thread fills its own cache line aligned SampleStats, so
+// the hot path takes no locks. Threads only meet on an atomic counter handing out chunks of
+// samples.
+template <int Rows, int Columns>
+class TourSampler {
+public:
+	using Attacks = KnightAttacks<Rows, Columns>;
+	static constexpr int tileCount = Rows * Columns;
+	using Stats = SampleStats<tileCount>;
+
+	explicit TourSampler(SamplerOptions options = {}) : options(options) {
+		if(this->options.threads <= 0)
+			this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// A tour a walk completed, with its importance weight.
+	struct WeightedTour {
+		uint64_t sample;	// Index of the walk that found it.
+		double weight;		// One over the probability of the walk, the product of its choices.
+		std::array<uint8_t, tileCount> tiles;
+	};
+
+	Stats sample(int start, uint64_t samples) const {
+		const uint64_t chunks = chunk_count(samples);
+		const int threads = thread_count(chunks);
+		std::vector<ThreadStats> threadStats(threads);
+		// Knuth weights are summed per chunk and the chunks in order, so rounding is the same
+		// for every schedule.
+		std::vector<double> chunkWeights(chunks, 0.0);
+		const SplitMix64 root(options.seed);
+
+		for_each_chunk(chunks, threads, [&](int thread, uint64_t chunk) {
+			double weights = 0.0;
+			uint64_t last = std::min(samples, (chunk + 1) * chunkSize);
+			for(uint64_t i = chunk * chunkSize; i < last; ++i) {
+				SplitMix64 random = root.split(i);
+				weights += walk(start, random, threadStats[thread].stats);
+			}
+			chunkWeights[chunk] = weights;
+		});
+
+		Stats result;
+		for(const ThreadStats& stats : threadStats)
+			result.merge(stats.stats);
+		if(options.policy == BatchPolicy::Uniform && samples > 0) {
+			double total = 0.0;
+			for(double weight : chunkWeights)
+				total += weight;
+			result.estimatedTours = total / samples;
+		}
+		return result;
+	}
+
+	// The tours completed by the same walks sample() makes, in sample order for any thread count.
+	// The mean of weight * f(tour) over all samples estimates the sum of f over every tour, so
+	// dividing by the sum of the weights gives its mean over uniform tours.
+	std::vector<WeightedTour> sample_tours(int start, uint64_t samples) const {
+		const uint64_t chunks = chunk_count(samples);
+		const int threads = thread_count(chunks);
+		std::vector<ThreadStats> threadStats(threads);
+		std::vector<std::vector<WeightedTour>> chunkTours(chunks);
+		const SplitMix64 root(options.seed);
+
+		for_each_chunk(chunks, threads, [&](int thread, uint64_t chunk) {
+			WeightedTour tour{};
+			uint64_t last = std::min(samples, (chunk + 1) * chunkSize);
+			for(uint64_t i = chunk * chunkSize; i < last; ++i) {
+				SplitMix64 random = root.split(i);
+				tour.weight = walk(start, random, threadStats[thread].stats, tour.tiles.data());
+				if(tour.weight > 0.0) {
+					tour.sample = i;
+					chunkTours[chunk].push_back(tour);
+				}
+			}
+		});
+
+		std::vector<WeightedTour> tours;
+		for(const auto& found : chunkTours)
+			tours.insert(tours.end(), found.begin(), found.end());
+		return tours;
+	}
+
+private:
+	static constexpr uint64_t chunkSize = 4096;
+
+	struct alignas(64) ThreadStats {
+		Stats stats;
+	};
+
+	static uint64_t chunk_count(uint64_t samples) { return (samples + chunkSize - 1) / chunkSize; }
+
+	int thread_count(uint64_t chunks) const {
+		return static_cast<int>(std::min<uint64_t>(options.threads, std::max<uint64_t>(chunks, 1)));
+	}
+
+	// Hands the chunks out to the threads through an atomic counter.
+	template <typename Visit>
+	static void for_each_chunk(uint64_t chunks, int threads, Visit&& visit) {
+		std::atomic<uint64_t> nextChunk{ 0 };
+		auto worker = [&](int thread) {
+			for(uint64_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++)
+				visit(thread, chunk);
+		};
+
+		std::vector<std::thread> workers;
+		for(int i = 1; i < threads; ++i)
+			workers.emplace_back(worker, i);
+		worker(0);
+		for(auto& thread : workers)
+			thread.join();
+	}
+
+	// One walk from start, written to path when given. Returns one over the probability of the
+	// walk if it became a tour, else 0. For uniform walks that is Knuth's weight.
+	double walk(int start, SplitMix64& random, Stats& stats, uint8_t* path = nullptr) const {
+		Bitboard visited = square_bit(start);
+		int current = start;
+		int length = 1;
+		double weight = 1.0;
+		if(path)
+			path[0] = static_cast<uint8_t>(start);
+
+		for(;;) {
+			Bitboard candidates = Attacks::visitable(current, visited);
+			if(candidates == 0)
+				break;
+
+			if(options.policy == BatchPolicy::Warnsdorff)
+				candidates = fewest_onward(candidates, visited);
+			int count = popcount(candidates);
+			weight *= count;
+
+			int skip = static_cast<int>(random.next_below(static_cast<uint32_t>(count)));
+			for(; skip > 0; --skip)
+				candidates &= candidates - 1;
+			current = lowest_square(candidates);
+			visited |= square_bit(current);
+			if(path)
+				path[length] = static_cast<uint8_t>(current);
+			++length;
+		}
+
+		++stats.samples;
+		++stats.endSquares[current];
+		++stats.lengths[length];
+		if(length < tileCount)
+			return 0.0;
+		++stats.fullTours;
+		if(Attacks::table[current] & square_bit(start))
+			++stats.closedTours;
+		return weight;
+	}
+
+	// The candidates with the fewest onward moves.
+	static Bitboard fewest_onward(Bitboard candidates, Bitboard visited) {
+		Bitboard best = 0;
+		int bestDegree = 9;
+		while(candidates) {
+			int tile = pop_lowest_square(candidates);
+			int degree = Attacks::degree(tile, visited | square_bit(tile));
+			if(degree < bestDegree) {
+				bestDegree = degree;
+				best = 0;
+			}
+			if(degree == bestDegree)
+				best |= square_bit(tile);
+		}
+		return best;
+	}
+
+	SamplerOptions options;
+};
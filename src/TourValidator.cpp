@@ -0,0 +1,247 @@
+#include "TourValidator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "KnightsTour.h"
+#include "MappedFile.h"
+#include "TourFile.h"
+
+namespace {
+
+bool is_letter(uint8_t character) { return static_cast<uint8_t>((character | 0x20) - 'a') < 26; }
+bool is_digit(uint8_t character) { return static_cast<uint8_t>(character - '0') < 10; }
+bool is_alphanumeric(uint8_t character) { return is_letter(character) || is_digit(character); }
+
+// Largest board the validator takes.
+constexpr int64_t maxTiles = int64_t(1) << 40;
+
+// Tokens with more letters or digits than this are off every board. A token is parsed by
+// reading at most tokenBytes bytes from its start.
+constexpr int maxLetters = 8;
+constexpr int maxDigits = 12;
+constexpr size_t tokenBytes = maxLetters + maxDigits + 1;
+
+enum class ParseResult { Done, Invalid, BadToken };
+
+// Feeds the chess notation tokens starting before stop to validator. At least tokenBytes bytes
+// past stop must be readable. Stops early on an invalid tour, or on a token that is not
+// notation, which is returned in badToken.
+ParseResult parse_tiles(const uint8_t*& position, const uint8_t* stop, TourValidator& validator, const uint8_t*& badToken) {
+	while(position < stop) {
+		uint8_t character = *position;
+		if(is_letter(character) == false) {
+			if(is_digit(character)) {
+				badToken = position;
+				return ParseResult::BadToken;
+			}
+			++position;
+			continue;
+		}
+
+		// Column letters in base 26 like chess_notation_to_index, then the row number.
+		const uint8_t* token = position;
+		int64_t column = 0;
+		int letters = 0;
+		do {
+			column = column * 26 + ((character | 0x20) - 'a' + 1);
+			character = *++position;
+		} while(++letters < maxLetters && is_letter(character));
+
+		int64_t row = 0;
+		int digits = 0;
+		while(digits < maxDigits && is_digit(character)) {
+			row = row * 10 + (character - '0');
+			character = *++position;
+			++digits;
+		}
+
+		if(row == 0 || is_alphanumeric(character)) {
+			badToken = token;
+			return ParseResult::BadToken;
+		}
+		if(validator.add(row - 1, column - 1) == false)
+			return ParseResult::Invalid;
+	}
+	return ParseResult::Done;
+}
+
+// Tours per work item when a binary file is split over threads.
+constexpr uint64_t chunkSize = 4096;
+
+ValidationReport validate_tour_file(const std::string& path, bool closed, int threads) {
+	TourFileReader reader(path);
+	ValidationReport report;
+	report.tours = reader.size();
+
+	const uint64_t chunks = (reader.size() + chunkSize - 1) / chunkSize;
+	threads = static_cast<int>(std::min<uint64_t>(std::max(threads, 1), std::max<uint64_t>(chunks, 1)));
+	std::atomic<uint64_t> nextChunk{ 0 };
+	std::atomic<uint64_t> firstFailure{ UINT64_MAX };
+	std::atomic<uint64_t> tiles{ 0 };
+	std::mutex failureMutex;
+
+	// Built here so a board the validator rejects throws on this thread, not in a worker.
+	std::vector<TourValidator> validators(threads, TourValidator(reader.rows(), reader.columns(), closed));
+
+	auto worker = [&](int thread) {
+		TourValidator& validator = validators[thread];
+		uint64_t checked = 0;
+		for(uint64_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+			// Chunks are handed out in order, so every tour before a failure is still checked
+			// and the lowest failing tour wins whatever the schedule.
+			uint64_t first = chunk * chunkSize;
+			if(first > firstFailure.load(std::memory_order_relaxed))
+				break;
+			uint64_t last = std::min(reader.size(), first + chunkSize);
+			for(uint64_t tour = first; tour < last; ++tour) {
+				validator.begin();
+				reader.for_each_position(tour, [&](int row, int column) { validator.add(row, column); });
+				checked += static_cast<uint64_t>(validator.moves());
+				if(validator.finish() == false) {
+					std::lock_guard<std::mutex> lock(failureMutex);
+					if(tour < firstFailure.load(std::memory_order_relaxed)) {
+						firstFailure.store(tour, std::memory_order_relaxed);
+						report.violation = validator.violation();
+					}
+					break;
+				}
+			}
+		}
+		tiles += checked;
+	};
+
+	std::vector<std::thread> workers;
+	for(int i = 1; i < threads; ++i)
+		workers.emplace_back(worker, i);
+	worker(0);
+	for(auto& thread : workers)
+		thread.join();
+
+	report.tiles = tiles;
+	report.valid = firstFailure == UINT64_MAX;
+	if(report.valid == false)
+		report.failedTour = firstFailure;
+	return report;
+}
+
+}
+
+TourValidator::TourValidator(int64_t rows, int64_t columns, bool closed) : rowCount(rows), columnCount(columns), closed(closed) {
+	if(rows < 1 || columns < 1 || rows > maxTiles / columns)
+		throw std::invalid_argument("Boards must have between 1 and 2^40 tiles.");
+	visited.resize(static_cast<size_t>((tile_count() + 63) / 64));
+}
+
+void TourValidator::begin() {
+	std::fill(visited.begin(), visited.end(), 0);
+	moveCount = 0;
+	failed = false;
+	firstViolation = TourViolation();
+}
+
+bool TourValidator::finish() {
+	if(failed)
+		return false;
+	if(moveCount < tile_count())
+		return fail(-1, "Only " + std::to_string(moveCount) + " of " + std::to_string(tile_count()) + " tiles visited.");
+	if(closed && is_knight_move(lastRow, lastColumn, firstRow, firstColumn) == false) {
+		return fail(lastRow * columnCount + lastColumn, "Move " + std::to_string(moveCount) + ": " + tile_name(lastRow, lastColumn)
+			+ " is not a knight's move from " + tile_name(firstRow, firstColumn) + ", so the tour is not closed.");
+	}
+	return true;
+}
+
+std::string TourValidator::tile_name(int64_t row, int64_t column) const {
+	if(row < 0 || row >= rowCount || column < 0 || column >= columnCount)
+		return "row " + std::to_string(row + 1) + ", column " + std::to_string(column + 1);
+	return KnightsTour::index_to_chess_notation(row * columnCount + column, static_cast<int>(columnCount));
+}
+
+bool TourValidator::fail(int64_t tile, std::string message) {
+	failed = true;
+	firstViolation.move = moveCount;
+	firstViolation.tile = tile;
+	firstViolation.message = std::move(message);
+	return false;
+}
+
+bool TourValidator::fail_off_board(int64_t row, int64_t column) {
+	return fail(-1, "Move " + std::to_string(moveCount) + ": " + tile_name(row, column) + " is off the "
+		+ std::to_string(rowCount) + "x" + std::to_string(columnCount) + " board.");
+}
+
+bool TourValidator::fail_not_knight_move(int64_t tile) {
+	return fail(tile, "Move " + std::to_string(moveCount) + ": " + tile_name(tile / columnCount, tile % columnCount)
+		+ " is not a knight's move from " + tile_name(lastRow, lastColumn) + ".");
+}
+
+bool TourValidator::fail_visited_twice(int64_t tile) {
+	return fail(tile, "Move " + std::to_string(moveCount) + ": " + tile_name(tile / columnCount, tile % columnCount) + " was already visited.");
+}
+
+ValidationReport validate_text(const uint8_t* data, size_t size, int64_t rows, int64_t columns, bool closed) {
+	ValidationReport report;
+	report.tours = 1;
+	report.bytes = size;
+	TourValidator validator(rows, columns, closed);
+
+	// Most of the file is parsed in place. The last few bytes are copied into a buffer padded
+	// with separators, so the parser never has to check for the end of a token.
+	const uint8_t* position = data;
+	const uint8_t* end = data + size;
+	const uint8_t* badToken = nullptr;
+	const uint8_t* readableEnd = end;
+	ParseResult result = ParseResult::Done;
+	if(size > tokenBytes)
+		result = parse_tiles(position, end - tokenBytes, validator, badToken);
+
+	std::vector<uint8_t> tail;
+	if(result == ParseResult::Done) {
+		tail.assign(position, end);
+		size_t length = tail.size();
+		tail.resize(length + tokenBytes, '\n');
+		position = tail.data();
+		readableEnd = tail.data() + tail.size();
+		result = parse_tiles(position, tail.data() + length, validator, badToken);
+	}
+
+	report.tiles = static_cast<uint64_t>(validator.moves());
+	if(result == ParseResult::BadToken) {
+		const uint8_t* tokenEnd = badToken;
+		while(tokenEnd < readableEnd && tokenEnd - badToken < 32 && is_alphanumeric(*tokenEnd))
+			++tokenEnd;
+		report.violation.move = validator.moves() + 1;
+		report.violation.message = "Move " + std::to_string(report.violation.move) + ": "
+			+ std::string(badToken, tokenEnd) + " is not a tile in chess notation.";
+		return report;
+	}
+
+	report.valid = validator.finish();
+	if(report.valid == false)
+		report.violation = validator.violation();
+	return report;
+}
+
+ValidationReport validate_file(const std::string& path, int64_t rows, int64_t columns, bool closed, int threads) {
+	ValidationReport report;
+	try {
+		MappedFile file(path);
+		if(TourFileReader::is_tour_file(file.data(), file.size()))
+			report = validate_tour_file(path, closed, threads);
+		else if(rows < 1 || columns < 1)
+			report.violation.message = "Text tours need a board size.";
+		else
+			report = validate_text(file.data(), file.size(), rows, columns, closed);
+		report.bytes = file.size();
+	}
+	catch(const std::exception& exception) {
+		report = ValidationReport();
+		report.violation.message = exception.what();
+	}
+	report.path = path;
+	return report;
+}
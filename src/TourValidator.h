@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+
+// First thing wrong with a tour. Moves count tiles from 1, like the move numbers on the board.
+struct TourViolation {
+	int64_t move = 0;
+	int64_t tile = -1;		// Offending tile, or -1 when it is not on the board.
+	std::string message;
+};
+
+// The knight's jumps of knightRowOffsets / knightColumnOffsets as a table indexed by the row
+// and column deltas plus 2.
+struct KnightJumps {
+	bool jumps[5][5] = {};
+	constexpr KnightJumps() {
+		for(int i = 0; i < 8; ++i)
+			jumps[knightRowOffsets[i] + 2][knightColumnOffsets[i] + 2] = true;
+	}
+};
+
+inline constexpr KnightJumps knightJumps{};
+
+// Checks one tour at a time, a tile at a time, so tours never have to be held in memory:
+// every tile is on the board and visited once, consecutive tiles are a knight's move apart
+// and, for closed tours, the last tile is a knight's move from the first.
+// Memory is one bit per tile, so boards of a billion tiles are fine.
+class TourValidator {
+public:
+	TourValidator(int64_t rows, int64_t columns, bool closed);
+
+	int64_t rows() const { return rowCount; }
+	int64_t columns() const { return columnCount; }
+	int64_t tile_count() const { return rowCount * columnCount; }
+
+	// Forgets the last tour.
+	void begin();
+
+	// Adds the next tile of the tour. Returns false once the tour has a violation, after which
+	// further tiles are ignored.
+	bool add(int64_t row, int64_t column) {
+		if(failed)
+			return false;
+		++moveCount;
+		if(row < 0 || row >= rowCount || column < 0 || column >= columnCount)
+			return fail_off_board(row, column);
+
+		int64_t tile = row * columnCount + column;
+		if(moveCount > 1 && is_knight_move(lastRow, lastColumn, row, column) == false)
+			return fail_not_knight_move(tile);
+
+		uint64_t& word = visited[static_cast<size_t>(tile >> 6)];
+		uint64_t bit = uint64_t(1) << (tile & 63);
+		if(word & bit)
+			return fail_visited_twice(tile);
+		word |= bit;
+		if(moveCount == 1) {
+			firstRow = row;
+			firstColumn = column;
+		}
+		lastRow = row;
+		lastColumn = column;
+		return true;
+	}
+
+	// Call after the last tile. Checks that every tile was visited and that closed tours close.
+	bool finish();
+
+	bool valid() const { return failed == false; }
+	const TourViolation& violation() const { return firstViolation; }
+	int64_t moves() const { return moveCount; }
+
+	static bool is_knight_move(int64_t fromRow, int64_t fromColumn, int64_t toRow, int64_t toColumn) {
+		uint64_t rowDelta = static_cast<uint64_t>(toRow - fromRow + 2);
+		uint64_t columnDelta = static_cast<uint64_t>(toColumn - fromColumn + 2);
+		return rowDelta < 5 && columnDelta < 5 && knightJumps.jumps[rowDelta][columnDelta];
+	}
+
+	// Tile name for reports: chess notation on the board, (row, column) off it.
+	std::string tile_name(int64_t row, int64_t column) const;
+
+private:
+	bool fail(int64_t tile, std::string message);
+	bool fail_off_board(int64_t row, int64_t column);
+	bool fail_not_knight_move(int64_t tile);
+	bool fail_visited_twice(int64_t tile);
+
+	int64_t rowCount;
+	int64_t columnCount;
+	bool closed;
+	std::vector<uint64_t> visited;
+	int64_t moveCount = 0;
+	int64_t firstRow = 0;
+	int64_t firstColumn = 0;
+	int64_t lastRow = 0;
+	int64_t lastColumn = 0;
+	bool failed = false;
+	TourViolation firstViolation;
+};
+
+// Outcome of checking one file.
+struct ValidationReport {
+	std::string path;
+	bool valid = false;
+	uint64_t tours = 0;			// Tours in the file.
+	uint64_t tiles = 0;
+	uint64_t bytes = 0;
+	uint64_t failedTour = 0;	// Which tour in the file is invalid, when valid is false.
+	TourViolation violation;	// Also holds errors opening or reading the file.
+};
+
+// Checks a tour written in chess notation, one tile per token, like LargeTour::write. Anything
+// that is not a letter or digit separates tiles, and letters may be lower case.
+ValidationReport validate_text(const uint8_t* data, size_t size, int64_t rows, int64_t columns, bool closed);
+
+// Memory maps path and checks it. Binary tour files (TourFile.h) are recognised by their
+// header, which also gives the board size, and their tours are split over threads. Anything
+// else is read as text on a rows x columns board. The first invalid tour is reported the same
+// way for any thread count.
+ValidationReport validate_file(const std::string& path, int64_t rows, int64_t columns, bool closed, int threads = 1);
@@ -0,0 +1,20 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(size_t memoryBytes, ReplacementPolicy policy)
+	: policy(policy) {
+	// Largest power of two number of entries that fits the budget, at least one.
+	size_t count = 1;
+	while(count * 2 * sizeof(Entry) <= memoryBytes)
+		count *= 2;
+
+	entries = std::make_unique<Entry[]>(count);
+	mask = count - 1;
+	clear();
+}
+
+void TranspositionTable::clear() {
+	for(size_t i = 0; i <= mask; ++i) {
+		entries[i].check.store(0, std::memory_order_relaxed);
+		entries[i].data.store(0, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// What to do when a new result maps to a slot that already holds a different position.
+enum class ReplacementPolicy {
+	AlwaysReplace,	// Newest result wins.
+	DepthPreferred	// Keep whichever result covers more remaining tiles (the costlier subtree).
+};
+
+// Fixed size, lock-free cache of search results keyed by a 64 bit position hash.
+// Each slot holds the number of ways to finish the tour from a position (zero means a dead
+// position) together with how many tiles were left to visit there.
+//
+// Slots are two relaxed atomic words, the data and key ^ data. A torn read from a concurrent
+// write makes the check fail and reads as a miss, so many threads can share one table
+// without locks (Hyatt and Mann's lockless hashing).
+class TranspositionTable {
+public:
+	explicit TranspositionTable(size_t memoryBytes, ReplacementPolicy policy = ReplacementPolicy::DepthPreferred);
+
+	bool probe(uint64_t key, uint64_t& count) const {
+		const Entry& entry = entries[key & mask];
+		uint64_t data = entry.data.load(std::memory_order_relaxed);
+		uint64_t check = entry.check.load(std::memory_order_relaxed);
+		if(data == 0 || (check ^ data) != key)
+			return false;
+		count = data >> 8;
+		return true;
+	}
+
+	// remaining must be between 1 and 255, count below 2^56.
+	void store(uint64_t key, uint64_t count, int remaining) {
+		Entry& entry = entries[key & mask];
+		if(policy == ReplacementPolicy::DepthPreferred) {
+			uint64_t old = entry.data.load(std::memory_order_relaxed);
+			if(old != 0 && static_cast<int>(old & 0xFF) > remaining)
+				return;
+		}
+		uint64_t data = (count << 8) | static_cast<uint64_t>(remaining);
+		entry.data.store(data, std::memory_order_relaxed);
+		entry.check.store(key ^ data, std::memory_order_relaxed);
+	}
+
+	void clear();
+
+	size_t capacity() const { return mask + 1; }
+	size_t memory_bytes() const { return capacity() * sizeof(Entry); }
+
+private:
+	struct Entry {
+		std::atomic<uint64_t> check;
+		std::atomic<uint64_t> data;
+	};
+
+	std::unique_ptr<Entry[]> entries;
+	size_t mask;
+	ReplacementPolicy policy;
+};
+
+// Deterministic 64 bit key for a tile in one of several roles (visited, current, start).
+inline constexpr uint64_t zobrist_key(int tile, int role) {
+	uint64_t z = static_cast<uint64_t>(role * 65536 + tile + 1) * 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Bitboard.h"
+#include "Random.h"
+
+// How Warnsdorff's rule picks between tiles that have the same number of onward moves.
+enum class TieBreak {
+	FirstFound,		// Lowest tile index.
+	Pohl,			// Smallest sum of onward moves one ply further (Pohl's lookahead).
+	SquirrelCull,	// Fixed knight direction priority, in the style of Squirrel and Cull.
+	Random			// Uniformly random, reproducible for a given seed.
+};
+
+// Warnsdorff's rule: always move to the tile with the fewest onward moves.
+// Works on bitboards only and never allocates, so it can be run millions of times.
+template <int Rows, int Columns>
+class Warnsdorff {
+public:
+	using Attacks = KnightAttacks<Rows, Columns>;
+	static constexpr int tileCount = Rows * Columns;
+	using Tour = std::array<uint8_t, tileCount>;
+
+	explicit Warnsdorff(TieBreak tieBreak = TieBreak::FirstFound, uint64_t seed = 0)
+		: tieBreak(tieBreak), random(seed) {}
+
+	// Walks a tour starting at start and writes the visited tiles to tour in order.
+	// Returns the number of tiles visited, which is tileCount when a full tour was found.
+	int solve(int start, Tour& tour) {
+		Bitboard visited = square_bit(start);
+		int current = start;
+		int length = 0;
+		tour[length++] = static_cast<uint8_t>(start);
+
+		while(length < tileCount) {
+			Bitboard candidates = Attacks::visitable(current, visited);
+			if(candidates == 0)
+				break;
+
+			current = choose(current, candidates, visited);
+			visited |= square_bit(current);
+			tour[length++] = static_cast<uint8_t>(current);
+		}
+
+		return length;
+	}
+
+private:
+	int choose(int current, Bitboard candidates, Bitboard visited) {
+		// Collect every candidate sharing the lowest onward degree.
+		int bestDegree = 9;
+		Bitboard ties = 0;
+		while(candidates) {
+			int tile = pop_lowest_square(candidates);
+			int degree = Attacks::degree(tile, visited);
+			if(degree < bestDegree) {
+				bestDegree = degree;
+				ties = square_bit(tile);
+			}
+			else if(degree == bestDegree)
+				ties |= square_bit(tile);
+		}
+
+		if((ties & (ties - 1)) == 0)
+			return lowest_square(ties);
+
+		switch(tieBreak) {
+		case TieBreak::Pohl:
+			return pohl_tie_break(ties, visited);
+		case TieBreak::SquirrelCull:
+			return direction_tie_break(current, ties);
+		case TieBreak::Random: {
+			int skip = static_cast<int>(random.next_below(static_cast<uint32_t>(popcount(ties))));
+			for(; skip > 0; --skip)
+				ties &= ties - 1;
+			return lowest_square(ties);
+		}
+		case TieBreak::FirstFound:
+		default:
+			return lowest_square(ties);
+		}
+	}
+
+	// Prefers the tie whose own onward tiles have the fewest onward moves in total.
+	static int pohl_tie_break(Bitboard ties, Bitboard visited) {
+		int best = -1;
+		int bestScore = 65;
+		while(ties) {
+			int tile = pop_lowest_square(ties);
+			Bitboard visitedAfter = visited | square_bit(tile);
+			Bitboard onward = Attacks::visitable(tile, visitedAfter);
+			int score = 0;
+			while(onward)
+				score += Attacks::degree(pop_lowest_square(onward), visitedAfter);
+			if(score < bestScore) {
+				bestScore = score;
+				best = tile;
+			}
+		}
+		return best;
+	}
+
+	// Prefers the tie reached by the highest priority knight direction.
+	static int direction_tie_break(int current, Bitboard ties) {
+		// Directions as (row, column) offsets, highest priority first.
+		constexpr int rowOffsets[8]    = { 1, 2, 2, 1, -1, -2, -2, -1 };
+		constexpr int columnOffsets[8] = { 2, 1, -1, -2, -2, -1, 1, 2 };
+
+		int row = current / Columns;
+		int column = current % Columns;
+		for(int i = 0; i < 8; ++i) {
+			int targetRow = row + rowOffsets[i];
+			int targetColumn = column + columnOffsets[i];
+			if(targetRow < 0 || targetRow >= Rows || targetColumn < 0 || targetColumn >= Columns)
+				continue;
+			int target = Columns * targetRow + targetColumn;
+			if(ties & square_bit(target))
+				return target;
+		}
+		return lowest_square(ties);
+	}
+
+	TieBreak tieBreak;
+	SplitMix64 random;
+};
+
+// Warnsdorff's rule on any board type from Board.h, for boards too big for a bitboard.
+// Keeps the onward degree of every tile up to date around each move, so a whole tour costs
+// O(tiles). Writes the visited tiles to tour and returns how many were visited.
+template <typename BoardType>
+int warnsdorff_tour(const BoardType& board, int start, std::vector<uint32_t>& tour,
+	TieBreak tieBreak = TieBreak::FirstFound, uint64_t seed = 0) {
+	const int tileCount = board.tile_count();
+	std::vector<uint8_t> degree(tileCount);
+	std::vector<uint8_t> visited(tileCount, 0);
+	for(int i = 0; i < tileCount; ++i)
+		degree[i] = static_cast<uint8_t>(board.move_count(i));
+
+	SplitMix64 random(seed);
+	auto visit = [&](int index) {
+		visited[index] = 1;
+		board.for_each_move(index, [&](int target) { --degree[target]; });
+		tour.push_back(static_cast<uint32_t>(index));
+	};
+
+	// Same direction priority as Warnsdorff<Rows, Columns>, as a row/column delta lookup. A jump
+	// over a wrapped edge (BoardTopology::Cylinder or Torus) is a whole board width or height
+	// away from its offset, so deltas are brought back into -2..2 first. Wrapped sides shorter
+	// than 5 can still alias, so those match modulo the side length.
+	auto direction_priority = [&](int from, int to) {
+		constexpr int rowOffsets[8]    = { 1, 2, 2, 1, -1, -2, -2, -1 };
+		constexpr int columnOffsets[8] = { 2, 1, -1, -2, -2, -1, 1, 2 };
+		auto unwrap = [](int delta, int size) { return delta > 2 ? delta - size : delta < -2 ? delta + size : delta; };
+		int rowDelta = unwrap(board.row(to) - board.row(from), board.rows());
+		int columnDelta = unwrap(board.column(to) - board.column(from), board.columns());
+		for(int i = 0; i < 8; ++i) {
+			if(rowOffsets[i] == rowDelta && columnOffsets[i] == columnDelta)
+				return i;
+		}
+		for(int i = 0; i < 8; ++i) {
+			if((rowDelta - rowOffsets[i]) % board.rows() == 0 && (columnDelta - columnOffsets[i]) % board.columns() == 0)
+				return i;
+		}
+		return 8;
+	};
+
+	auto pohl_score = [&](int candidate) {
+		int score = 0;
+		board.for_each_move(candidate, [&](int target) {
+			if(visited[target] == 0)
+				score += degree[target] - 1;
+		});
+		return score;
+	};
+
+	tour.clear();
+	tour.reserve(tileCount);
+	visit(start);
+	int current = start;
+
+	while(static_cast<int>(tour.size()) < tileCount) {
+		int ties[8];
+		int tieCount = 0;
+		int bestDegree = 9;
+		board.for_each_move(current, [&](int target) {
+			if(visited[target])
+				return;
+			if(degree[target] < bestDegree) {
+				bestDegree = degree[target];
+				tieCount = 0;
+			}
+			if(degree[target] == bestDegree)
+				ties[tieCount++] = target;
+		});
+
+		if(tieCount == 0)
+			break;
+
+		int next = ties[0];
+		switch(tieBreak) {
+		case TieBreak::Pohl: {
+			int bestScore = pohl_score(next);
+			for(int i = 1; i < tieCount; ++i) {
+				int score = pohl_score(ties[i]);
+				if(score < bestScore || (score == bestScore && ties[i] < next)) {
+					bestScore = score;
+					next = ties[i];
+				}
+			}
+			break;
+		}
+		case TieBreak::SquirrelCull:
+			for(int i = 1; i < tieCount; ++i) {
+				if(direction_priority(current, ties[i]) < direction_priority(current, next))
+					next = ties[i];
+			}
+			break;
+		case TieBreak::Random:
+			next = ties[random.next_below(static_cast<uint32_t>(tieCount))];
+			break;
+		case TieBreak::FirstFound:
+		default:
+			for(int i = 1; i < tieCount; ++i) {
+				if(ties[i] < next)
+					next = ties[i];
+			}
+			break;
+		}
+
+		visit(next);
+		current = next;
+	}
+
+	return static_cast<int>(tour.size());
+}
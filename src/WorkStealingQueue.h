@@ -0,0 +1,37 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+// Double ended task queue owned by one worker thread. The owner pushes and pops at the back
+// (newest first, good locality), idle workers steal from the front (oldest, usually biggest).
+template <typename T>
+class WorkStealingQueue {
+public:
+	void push(T task) {
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+
+	bool pop(T& task) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if(tasks.empty())
+			return false;
+		task = std::move(tasks.back());
+		tasks.pop_back();
+		return true;
+	}
+
+	bool steal(T& task) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if(tasks.empty())
+			return false;
+		task = std::move(tasks.front());
+		tasks.pop_front();
+		return true;
+	}
+
+private:
+	std::mutex mutex;
+	std::deque<T> tasks;
+};
@@ -0,0 +1,254 @@
+// Solves many tours in one go and streams them to a binary tour file (see TourFile.h).
+//
+// Usage: BatchSolver --output file [options]
+//   --size RxC          board size, up to 16x16 (default 8x8)
+//   --starts all|A1,..  start tiles in chess notation (default all)
+//   --solver name       warnsdorff, pohl, squirrel, random or backtrack (default warnsdorff)
+//   --samples N         tours per start for the random solver (default 1)
+//   --seed N            seed for the random solver (default 0)
+//   --closed            backtrack only finds closed tours
+//   --max-tours N       backtrack stops after N tours per start (default no limit)
+//   --threads N         worker threads, 0 for every hardware thread (default 0)
+//
+// Warnsdorff solvers write one record per start (or sample), including tours that got
+// stuck. Backtracking writes every tour it finds and needs a board of at most 8x8.
+// With more than one thread the order of the records depends on scheduling.
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Board.h"
+#include "KnightsTour.h"
+#include "ParallelSearch.h"
+#include "Random.h"
+#include "TourFile.h"
+#include "Warnsdorff.h"
+
+namespace {
+
+struct Options {
+	int rows = 8;
+	int columns = 8;
+	std::string starts = "all";
+	std::string solver = "warnsdorff";
+	std::string output;
+	uint64_t samples = 1;
+	uint64_t seed = 0;
+	bool closed = false;
+	uint64_t maxTours = 0;
+	int threads = 0;
+};
+
+void print_usage() {
+	std::cout << "Usage: BatchSolver --output file [--size RxC] [--starts all|A1,B3,...]\n"
+		"                   [--solver warnsdorff|pohl|squirrel|random|backtrack] [--samples N]\n"
+		"                   [--seed N] [--closed] [--max-tours N] [--threads N]\n";
+}
+
+// Reads the whole of value as a number, failing on anything else or on overflow.
+template<typename T>
+bool parse_number(const std::string& value, T& number) {
+	const char* end = value.data() + value.size();
+	auto [last, error] = std::from_chars(value.data(), end, number);
+	return error == std::errc() && last == end;
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+	for(int i = 1; i < argc; ++i) {
+		std::string argument = argv[i];
+		if(argument == "--closed") {
+			options.closed = true;
+			continue;
+		}
+		if(i + 1 >= argc) {
+			std::cout << "Missing value for " << argument << ".\n";
+			return false;
+		}
+
+		std::string value = argv[++i];
+		bool valid = true;
+		if(argument == "--size") {
+			size_t separator = value.find_first_of("xX");
+			if(separator == std::string::npos) {
+				std::cout << "Board size should look like 8x8.\n";
+				return false;
+			}
+			valid = parse_number(value.substr(0, separator), options.rows) && parse_number(value.substr(separator + 1), options.columns);
+		}
+		else if(argument == "--starts")
+			options.starts = value;
+		else if(argument == "--solver")
+			options.solver = value;
+		else if(argument == "--output")
+			options.output = value;
+		else if(argument == "--samples")
+			valid = parse_number(value, options.samples);
+		else if(argument == "--seed")
+			valid = parse_number(value, options.seed);
+		else if(argument == "--max-tours")
+			valid = parse_number(value, options.maxTours);
+		else if(argument == "--threads")
+			valid = parse_number(value, options.threads);
+		else {
+			std::cout << "Unknown option " << argument << ".\n";
+			return false;
+		}
+		if(valid == false) {
+			std::cout << "Invalid value " << value << " for " << argument << ".\n";
+			return false;
+		}
+	}
+
+	if(options.output.empty()) {
+		std::cout << "An output file is required.\n";
+		return false;
+	}
+	if(options.rows < 1 || options.columns < 1 || options.rows > TourFileWriter::maxDimension || options.columns > TourFileWriter::maxDimension) {
+		std::cout << "Board size must be between 1x1 and 16x16.\n";
+		return false;
+	}
+	if(options.threads <= 0)
+		options.threads = std::max(1u, std::thread::hardware_concurrency());
+	return true;
+}
+
+bool parse_starts(const Options& options, std::vector<int>& starts) {
+	if(options.starts == "all") {
+		for(int i = 0; i < options.rows * options.columns; ++i)
+			starts.push_back(i);
+		return true;
+	}
+
+	size_t begin = 0;
+	while(begin <= options.starts.size()) {
+		size_t end = options.starts.find(',', begin);
+		if(end == std::string::npos)
+			end = options.starts.size();
+		int64_t index = KnightsTour::chess_notation_to_index(options.starts.substr(begin, end - begin), options.rows, options.columns);
+		if(index < 0)
+			return false;
+		starts.push_back(static_cast<int>(index));
+		begin = end + 1;
+	}
+	return true;
+}
+
+// Runs every (start, sample) pair through warnsdorff_tour, spread over the worker threads.
+void run_warnsdorff(const Options& options, const std::vector<int>& starts, TieBreak tieBreak, TourFileWriter& writer) {
+	DynamicBoard board(options.rows, options.columns);
+	const uint64_t samples = tieBreak == TieBreak::Random ? options.samples : 1;
+	const uint64_t jobs = starts.size() * samples;
+	std::atomic<uint64_t> nextJob{ 0 };
+	std::mutex writerMutex;
+
+	auto worker = [&]() {
+		std::vector<uint32_t> tour;
+		for(uint64_t job = nextJob++; job < jobs; job = nextJob++) {
+			// Every sample gets its own seed, so results do not depend on the thread count.
+			uint64_t seed = SplitMix64(options.seed + job).next();
+			warnsdorff_tour(board, starts[job / samples], tour, tieBreak, seed);
+			std::lock_guard<std::mutex> lock(writerMutex);
+			writer.add(tour.data(), static_cast<int>(tour.size()));
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for(int i = 1; i < options.threads; ++i)
+		workers.emplace_back(worker);
+	worker();
+	for(auto& thread : workers)
+		thread.join();
+}
+
+template <int Rows, int Columns>
+void run_backtracking(const Options& options, const std::vector<int>& starts, TourFileWriter& writer) {
+	ParallelOptions parallel;
+	parallel.threads = options.threads;
+	parallel.limits.maxTours = options.maxTours;
+	ParallelSearch<Rows, Columns> search(options.closed ? TourType::Closed : TourType::Open, parallel);
+
+	std::mutex writerMutex;
+	for(int start : starts) {
+		search.enumerate(start, [&](int, const typename ParallelSearch<Rows, Columns>::Tour& tour) {
+			std::lock_guard<std::mutex> lock(writerMutex);
+			writer.add(tour.data(), Rows * Columns);
+			return true;
+		});
+	}
+}
+
+// Calls f with the board size as compile time constants, for sizes from 3x3 to 8x8.
+template <int Rows = 3, int Columns = 3, typename Function>
+bool dispatch_size(int rows, int columns, Function&& f) {
+	if constexpr(Rows > 8)
+		return false;
+	else if constexpr(Columns > 8)
+		return dispatch_size<Rows + 1, 3>(rows, columns, f);
+	else {
+		if(rows == Rows && columns == Columns) {
+			f(std::integral_constant<int, Rows>{}, std::integral_constant<int, Columns>{});
+			return true;
+		}
+		return dispatch_size<Rows, Columns + 1>(rows, columns, f);
+	}
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	if(argc < 2 || parse_options(argc, argv, options) == false) {
+		print_usage();
+		return 1;
+	}
+
+	std::vector<int> starts;
+	if(parse_starts(options, starts) == false)
+		return 1;
+
+	auto begin = std::chrono::steady_clock::now();
+	try {
+		TourFileWriter writer(options.output, options.rows, options.columns);
+
+		if(options.solver == "backtrack") {
+			bool supported = dispatch_size(options.rows, options.columns, [&](auto rows, auto columns) {
+				run_backtracking<decltype(rows)::value, decltype(columns)::value>(options, starts, writer);
+			});
+			if(supported == false) {
+				std::cout << "Backtracking supports boards from 3x3 to 8x8.\n";
+				return 1;
+			}
+		}
+		else if(options.solver == "warnsdorff")
+			run_warnsdorff(options, starts, TieBreak::FirstFound, writer);
+		else if(options.solver == "pohl")
+			run_warnsdorff(options, starts, TieBreak::Pohl, writer);
+		else if(options.solver == "squirrel")
+			run_warnsdorff(options, starts, TieBreak::SquirrelCull, writer);
+		else if(options.solver == "random")
+			run_warnsdorff(options, starts, TieBreak::Random, writer);
+		else {
+			std::cout << "Unknown solver " << options.solver << ".\n";
+			return 1;
+		}
+
+		uint64_t tours = writer.tour_count();
+		writer.close();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		std::cout << "Wrote " << tours << " tours to " << options.output << " in " << seconds << "s ("
+			<< static_cast<long long>(tours / seconds) << " tours/s)\n";
+	}
+	catch(const std::exception& exception) {
+		std::cout << exception.what() << "\n";
+		return 1;
+	}
+	return 0;
+}
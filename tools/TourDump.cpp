@@ -0,0 +1,39 @@
+// Prints tours from a binary tour file in chess notation.
+// Usage: TourDump file [first tour] [tour count]
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "KnightsTour.h"
+#include "TourFile.h"
+
+int main(int argc, char* argv[]) {
+	if(argc < 2) {
+		std::cout << "Usage: TourDump file [first tour] [tour count]\n";
+		return 1;
+	}
+
+	try {
+		TourFileReader reader(argv[1]);
+		uint64_t first = argc > 2 ? std::stoull(argv[2]) : 0;
+		uint64_t count = argc > 3 ? std::stoull(argv[3]) : 10;
+
+		std::cout << reader.size() << " tours on " << reader.rows() << "x" << reader.columns() << "\n";
+
+		std::string line;
+		for(uint64_t number = first; number < reader.size() && number < first + count; ++number) {
+			line = std::to_string(number) + ":";
+			reader.for_each_tile(number, [&](int index) {
+				line += ' ';
+				line += KnightsTour::index_to_chess_notation(index, reader.columns());
+			});
+			std::cout << line << "\n";
+		}
+	}
+	catch(const std::exception& exception) {
+		std::cout << exception.what() << "\n";
+		return 1;
+	}
+	return 0;
+}
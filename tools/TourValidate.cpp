@@ -0,0 +1,138 @@
+// Checks tours from other programs: every tile visited once, knight's moves only and, with
+// --closed, a last tile a knight's move from the first. Prints the first violation of each
+// file and exits with 1 if any file is invalid.
+//
+// Usage: TourValidate [options] file...
+//   --size RxC    board size for text files, one tile in chess notation per token
+//   --closed      tours must be closed
+//   --threads N   worker threads, 0 for every hardware thread (default 0)
+//
+// Binary tour files (TourFile.h) carry their own board size. Files are checked in parallel,
+// and the tours of a binary file are split over the threads left over.
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TourValidator.h"
+
+namespace {
+
+struct Options {
+	int64_t rows = 0;
+	int64_t columns = 0;
+	bool closed = false;
+	int threads = 0;
+	std::vector<std::string> files;
+};
+
+void print_usage() {
+	std::cout << "Usage: TourValidate [--size RxC] [--closed] [--threads N] file...\n";
+}
+
+// Reads the whole of value as a number, failing on anything else or on overflow.
+template<typename T>
+bool parse_number(const std::string& value, T& number) {
+	const char* end = value.data() + value.size();
+	auto [last, error] = std::from_chars(value.data(), end, number);
+	return error == std::errc() && last == end;
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+	for(int i = 1; i < argc; ++i) {
+		std::string argument = argv[i];
+		if(argument == "--closed")
+			options.closed = true;
+		else if(argument == "--size" || argument == "--threads") {
+			if(i + 1 >= argc) {
+				std::cout << "Missing value for " << argument << ".\n";
+				return false;
+			}
+			std::string value = argv[++i];
+			bool valid;
+			if(argument == "--threads")
+				valid = parse_number(value, options.threads);
+			else {
+				size_t separator = value.find_first_of("xX");
+				if(separator == std::string::npos) {
+					std::cout << "Board size should look like 8x8.\n";
+					return false;
+				}
+				valid = parse_number(value.substr(0, separator), options.rows) && parse_number(value.substr(separator + 1), options.columns);
+			}
+			if(valid == false) {
+				std::cout << "Invalid value " << value << " for " << argument << ".\n";
+				return false;
+			}
+		}
+		else if(argument.size() > 1 && argument[0] == '-') {
+			std::cout << "Unknown option " << argument << ".\n";
+			return false;
+		}
+		else
+			options.files.push_back(argument);
+	}
+
+	if(options.files.empty()) {
+		std::cout << "No files to check.\n";
+		return false;
+	}
+	if(options.threads <= 0)
+		options.threads = std::max(1u, std::thread::hardware_concurrency());
+	return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	Options options;
+	if(argc < 2 || parse_options(argc, argv, options) == false) {
+		print_usage();
+		return 1;
+	}
+
+	auto begin = std::chrono::steady_clock::now();
+	const size_t fileCount = options.files.size();
+	const int fileThreads = static_cast<int>(std::min<size_t>(options.threads, fileCount));
+	const int threadsPerFile = std::max(1, options.threads / fileThreads);
+	std::vector<ValidationReport> reports(fileCount);
+	std::atomic<size_t> nextFile{ 0 };
+
+	auto worker = [&]() {
+		for(size_t file = nextFile++; file < fileCount; file = nextFile++)
+			reports[file] = validate_file(options.files[file], options.rows, options.columns, options.closed, threadsPerFile);
+	};
+
+	std::vector<std::thread> workers;
+	for(int i = 1; i < fileThreads; ++i)
+		workers.emplace_back(worker);
+	worker();
+	for(auto& thread : workers)
+		thread.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	// Reports in the order the files were given, whatever order they finished in.
+	uint64_t bytes = 0;
+	size_t invalid = 0;
+	for(const ValidationReport& report : reports) {
+		bytes += report.bytes;
+		if(report.valid)
+			std::cout << report.path << ": valid, " << report.tours << (report.tours == 1 ? " tour, " : " tours, ") << report.tiles << " tiles\n";
+		else {
+			++invalid;
+			std::cout << report.path << ": ";
+			if(report.tours > 1)
+				std::cout << "tour " << report.failedTour << ": ";
+			std::cout << report.violation.message << "\n";
+		}
+	}
+
+	std::cout << fileCount - invalid << " of " << fileCount << " files valid, " << bytes << " bytes in " << seconds << "s ("
+		<< static_cast<long long>(bytes / seconds / (1 << 20)) << " MB/s)\n";
+	return invalid == 0 ? 0 : 1;
+}